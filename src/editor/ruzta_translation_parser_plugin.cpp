@@ -302,6 +302,9 @@ void RuztaEditorTranslationParserPlugin::_assess_expression(const RuztaParser::E
 		case RuztaParser::Node::UNARY_OPERATOR: {
 			_assess_expression(static_cast<const RuztaParser::UnaryOpNode *>(p_expression)->operand);
 		} break;
+		case RuztaParser::Node::YIELD: {
+			_assess_expression(static_cast<const RuztaParser::YieldNode *>(p_expression)->value);
+		} break;
 		default: {
 		} break;
 	}
@@ -33,6 +33,7 @@
 #include "register_types.h"
 
 #include "ruzta.h"
+#include "ruzta_await_scheduler.h"
 #include "ruzta_cache.h"
 #ifdef TOOLS_ENABLED
 #include "ruzta_editor_plugin.h"
@@ -79,9 +80,13 @@ void initialize_ruzta_module(ModuleInitializationLevel p_level) {
 
 	if (p_level == MODULE_INITIALIZATION_LEVEL_SERVERS) {
 		GDREGISTER_CLASS(Ruzta);
+		GDREGISTER_INTERNAL_CLASS(RuztaFunctionState);
+		GDREGISTER_INTERNAL_CLASS(RuztaSleepTimer);
+		GDREGISTER_ABSTRACT_CLASS(RuztaAwaitScheduler);
 
 		script_language_rz = memnew(RuztaLanguage);
 		Engine::get_singleton()->register_script_language(script_language_rz);
+		Engine::get_singleton()->register_singleton("RuztaAwaitScheduler", script_language_rz->get_await_scheduler());
 
 		resource_loader_rz.instantiate();
 		ResourceLoader::get_singleton()->add_resource_format_loader(resource_loader_rz);
@@ -114,6 +119,7 @@ void uninitialize_ruzta_module(ModuleInitializationLevel p_level) {
 	}
 
 	if (p_level == MODULE_INITIALIZATION_LEVEL_SERVERS) {
+		Engine::get_singleton()->unregister_singleton("RuztaAwaitScheduler");
 		Engine::get_singleton()->unregister_script_language(script_language_rz);
 
 		if (ruzta_cache) {
@@ -33,11 +33,13 @@
 #include "ruzta.h"
 
 #include "ruzta_analyzer.h"
+#include "ruzta_await_scheduler.h"
 #include "ruzta_cache.h"
 #include "ruzta_compiler.h"
 #include "ruzta_parser.h"
 #include "ruzta_project_settings.h"
 #include "ruzta_rpc_callable.h"
+#include "ruzta_sampling_profiler.h"
 #include "ruzta_tokenizer_buffer.h"
 #include "ruzta_warning.h"
 #include "ruzta_script_server.h"
@@ -54,6 +56,7 @@
 #include <godot_cpp/classes/project_settings.hpp>  // original: core/config/project_settings.h
 #include "ruzta_variant/core_constants.h" // original: core/core_constants.h
 #include <godot_cpp/classes/file_access.hpp>   // original: core/io/file_access.h
+#include <godot_cpp/classes/json.hpp>          // original: core/io/json.h
 #include <godot_cpp/classes/packed_scene.hpp>  // original: scene/resources/packed_scene.h
 // TODO: #include "scene/scene_string_names.h" // original: scene/scene_string_names.h
 
@@ -65,6 +68,7 @@
 #include <godot_cpp/classes/engine_debugger.hpp>   // original:
 #include <godot_cpp/classes/global_constants.hpp>  // original:
 #include <godot_cpp/core/mutex_lock.hpp>		   // original:
+#include <godot_cpp/templates/local_vector.hpp>  // original: core/templates/local_vector.h
 
 ///////////////////////////
 bool RuztaNativeClass::_get(const StringName& p_name, Variant& r_ret) const {
@@ -270,6 +274,78 @@ void Ruzta::_static_default_init() {
 	}
 }
 
+void Ruzta::_update_method_tables() {
+	method_table.clear();
+	notification_chain.clear();
+
+	const StringName& notification_str = RuztaLanguage::get_singleton()->strings._notification;
+	for (Ruzta* sptr = this; sptr; sptr = sptr->base.ptr()) {
+		if (unlikely(!sptr->valid)) {
+			continue;
+		}
+		for (const KeyValue<StringName, RuztaFunction*>& E : sptr->member_functions) {
+			if (!method_table.has(E.key)) {
+				method_table.insert(E.key, E.value);
+			}
+		}
+		HashMap<StringName, RuztaFunction*>::ConstIterator E = sptr->member_functions.find(notification_str);
+		if (E) {
+			notification_chain.insert(0, E->value);
+		}
+	}
+	method_tables_valid = true;
+
+	for (KeyValue<StringName, Ref<Ruzta>>& E : subclasses) {
+		E.value->_update_method_tables();
+	}
+}
+
+bool Ruzta::_extends(const Ruzta* p_script) const {
+	for (const Ruzta* sptr = base.ptr(); sptr; sptr = sptr->base.ptr()) {
+		if (sptr == p_script) {
+			return true;
+		}
+	}
+	return false;
+}
+
+uint32_t Ruzta::new_member_layout_id() {
+	static SafeNumeric<uint32_t> last_member_layout_id;
+	return last_member_layout_id.increment();
+}
+
+// Called before the functions of this class are freed.
+void Ruzta::_invalidate_inheriter_method_tables() {
+	method_tables_valid = false;
+
+	MutexLock lock(RuztaLanguage::get_singleton()->mutex);
+	for (SelfList<Ruzta>* elem = RuztaLanguage::get_singleton()->script_list.first(); elem; elem = elem->next()) {
+		Ruzta* inheriter = elem->self();
+		if (inheriter->_extends(this)) {
+			inheriter->method_tables_valid = false;
+			inheriter->member_layout_id = new_member_layout_id(); // Drops call cache entries pointing to the old functions.
+		}
+	}
+}
+
+// Called once this class and its inner classes are compiled again.
+void Ruzta::_update_inheriter_method_tables() {
+	{
+		MutexLock lock(RuztaLanguage::get_singleton()->mutex);
+		for (SelfList<Ruzta>* elem = RuztaLanguage::get_singleton()->script_list.first(); elem; elem = elem->next()) {
+			Ruzta* inheriter = elem->self();
+			if (inheriter->_extends(this)) {
+				inheriter->_update_method_tables();
+				inheriter->member_layout_id = new_member_layout_id();
+			}
+		}
+	}
+
+	for (KeyValue<StringName, Ref<Ruzta>>& E : subclasses) {
+		E.value->_update_inheriter_method_tables();
+	}
+}
+
 RuztaFunction* Ruzta::_super_constructor(Ruzta* p_script) {
 	if (likely(p_script->valid) && p_script->initializer) {
 		return p_script->initializer;
@@ -858,6 +934,58 @@ Variant Ruzta::_new(const Variant** p_args, GDExtensionInt p_argcount, GDExtensi
 	}
 }
 
+Error Ruzta::start_sampling_profiler(int64_t p_interval_usec) {
+	ERR_FAIL_COND_V(p_interval_usec <= 0, ERR_INVALID_PARAMETER);
+	return RuztaLanguage::get_singleton()->start_sampling_profiler(p_interval_usec);
+}
+
+void Ruzta::stop_sampling_profiler() {
+	RuztaLanguage::get_singleton()->stop_sampling_profiler();
+}
+
+bool Ruzta::is_sampling_profiler_running() {
+	return RuztaLanguage::get_singleton()->is_sampling_profiler_running();
+}
+
+Dictionary Ruzta::get_sampling_profile() {
+	return RuztaLanguage::get_singleton()->get_sampling_profile();
+}
+
+String Ruzta::get_sampling_profile_collapsed() {
+	return RuztaLanguage::get_singleton()->get_sampling_profile_collapsed();
+}
+
+void Ruzta::reset_sampling_profile() {
+	RuztaLanguage::get_singleton()->reset_sampling_profile();
+}
+
+Error Ruzta::save_sampling_profile(const String& p_path) {
+	return RuztaLanguage::get_singleton()->save_sampling_profile(p_path);
+}
+
+#ifdef DEBUG_ENABLED
+PackedStringArray Ruzta::get_function_disassembly(const StringName& p_function) const {
+	HashMap<StringName, RuztaFunction*>::ConstIterator E = member_functions.find(p_function);
+	ERR_FAIL_COND_V_MSG(!E, PackedStringArray(), vformat(R"(Function "%s" not found in the script.)", p_function));
+	return E->value->get_disassembly();
+}
+#endif
+
+void Ruzta::_bind_methods() {
+	ClassDB::bind_vararg_method(METHOD_FLAGS_DEFAULT, "new", &Ruzta::_new, MethodInfo("new"));
+
+	ClassDB::bind_static_method("Ruzta", D_METHOD("start_sampling_profiler", "interval_usec"), &Ruzta::start_sampling_profiler, DEFVAL(10000));
+	ClassDB::bind_static_method("Ruzta", D_METHOD("stop_sampling_profiler"), &Ruzta::stop_sampling_profiler);
+	ClassDB::bind_static_method("Ruzta", D_METHOD("is_sampling_profiler_running"), &Ruzta::is_sampling_profiler_running);
+	ClassDB::bind_static_method("Ruzta", D_METHOD("get_sampling_profile"), &Ruzta::get_sampling_profile);
+	ClassDB::bind_static_method("Ruzta", D_METHOD("get_sampling_profile_collapsed"), &Ruzta::get_sampling_profile_collapsed);
+	ClassDB::bind_static_method("Ruzta", D_METHOD("reset_sampling_profile"), &Ruzta::reset_sampling_profile);
+	ClassDB::bind_static_method("Ruzta", D_METHOD("save_sampling_profile", "path"), &Ruzta::save_sampling_profile);
+#ifdef DEBUG_ENABLED
+	ClassDB::bind_method(D_METHOD("get_function_disassembly", "function"), &Ruzta::get_function_disassembly);
+#endif
+}
+
 bool Ruzta::_inherits_script(const Ref<Script>& p_script) const {
 	Ref<Ruzta> rz = p_script;
 	if (rz.is_null()) {
@@ -1311,10 +1439,13 @@ void Ruzta::clear(ClearData* p_clear_data) {
 		}
 	}
 
+	_invalidate_inheriter_method_tables();
 	for (const KeyValue<StringName, RuztaFunction*>& E : member_functions) {
 		clear_data->functions.insert(E.value);
 	}
 	member_functions.clear();
+	method_table.clear();
+	notification_chain.clear();
 
 	for (KeyValue<StringName, MemberInfo>& E : member_indices) {
 		clear_data->scripts.insert(E.value.data_type.script_type_ref);
@@ -2009,10 +2140,19 @@ void RuztaInstance::_call_implicit_ready_recursively(Ruzta* p_script) {
 
 Variant RuztaInstance::callp(const StringName& p_method, const Variant** p_args, int p_argcount, GDExtensionCallError& r_error) {
 	Ruzta* sptr = script.ptr();
-	if (unlikely(p_method == StringName("_ready"))) {
+	if (unlikely(p_method == RuztaLanguage::get_singleton()->strings._ready)) {
 		// Call implicit ready first, including for the super classes recursively.
 		_call_implicit_ready_recursively(sptr);
 	}
+	if (likely(sptr->valid && sptr->method_tables_valid)) {
+		HashMap<StringName, RuztaFunction*>::Iterator E = sptr->method_table.find(p_method);
+		if (E) {
+			return E->value->call(this, p_args, p_argcount, r_error);
+		}
+		r_error.error = GDExtensionCallErrorType::GDEXTENSION_CALL_ERROR_INVALID_METHOD;
+		return Variant();
+	}
+	// Invalid scripts still dispatch to their valid base classes, as do scripts whose base is being recompiled.
 	while (sptr) {
 		if (likely(sptr->valid)) {
 			HashMap<StringName, RuztaFunction*>::Iterator E = sptr->member_functions.find(p_method);
@@ -2027,22 +2167,15 @@ Variant RuztaInstance::callp(const StringName& p_method, const Variant** p_args,
 	return Variant();
 }
 
-void RuztaInstance::notification(int p_notification, bool p_reversed) {
-	if (unlikely(!script->valid)) {
-		return;
-	}
-
-	// notification is not virtual, it gets called at ALL levels just like in C.
-	Variant value = p_notification;
-	const Variant* args[1] = {&value};
+void RuztaInstance::_notification_base_chain(const Variant** p_args, bool p_reversed) {
 	const StringName& notification_str = RuztaLanguage::get_singleton()->strings._notification;
 
 	LocalVector<Ruzta*> script_stack;
-	uint32_t script_count = 0;
-	for (Ruzta* sptr = script.ptr(); sptr; sptr = sptr->base.ptr(), ++script_count) {
+	for (Ruzta* sptr = script.ptr(); sptr; sptr = sptr->base.ptr()) {
 		script_stack.push_back(sptr);
 	}
 
+	const int script_count = script_stack.size();
 	const int start = p_reversed ? 0 : script_count - 1;
 	const int end = p_reversed ? script_count : -1;
 	const int step = p_reversed ? 1 : -1;
@@ -2053,15 +2186,44 @@ void RuztaInstance::notification(int p_notification, bool p_reversed) {
 			HashMap<StringName, RuztaFunction*>::Iterator E = sc->member_functions.find(notification_str);
 			if (E) {
 				GDExtensionCallError err;
-				E->value->call(this, args, 1, err);
-				if (err.error != GDExtensionCallErrorType::GDEXTENSION_CALL_OK) {
-					// print error about notification call
-				}
+				E->value->call(this, p_args, 1, err);
 			}
 		}
 	}
 }
 
+void RuztaInstance::notification(int p_notification, bool p_reversed) {
+	if (unlikely(!script->valid)) {
+		return;
+	}
+
+	// notification is not virtual, it gets called at ALL levels just like in C.
+	Variant value = p_notification;
+	const Variant* args[1] = {&value};
+
+	if (unlikely(!script->method_tables_valid)) {
+		// A base is being recompiled, its functions may be gone from the chain.
+		_notification_base_chain(args, p_reversed);
+		return;
+	}
+
+	// The chain is rebuilt on reload, iterate a (copy-on-write) reference to it.
+	const Vector<RuztaFunction*> chain = script->notification_chain;
+	const int chain_count = chain.size();
+
+	const int start = p_reversed ? chain_count - 1 : 0;
+	const int end = p_reversed ? -1 : chain_count;
+	const int step = p_reversed ? -1 : 1;
+
+	for (int idx = start; idx != end; idx += step) {
+		GDExtensionCallError err;
+		chain[idx]->call(this, args, 1, err);
+		if (err.error != GDExtensionCallErrorType::GDEXTENSION_CALL_OK) {
+			// print error about notification call
+		}
+	}
+}
+
 String RuztaInstance::to_string(bool* r_valid) {
 	if (has_method(StringName("_to_string"))) {
 		GDExtensionCallError ce;
@@ -2202,7 +2364,17 @@ void RuztaLanguage::_remove_named_global_constant(const StringName& p_name) {
 	named_globals.erase(p_name);
 }
 
+void RuztaLanguage::update_optimization_settings() {
+	adaptive_quickening = GLOBAL_GET("ruzta/optimizations/adaptive_quickening");
+	threaded_dispatch = GLOBAL_GET("ruzta/optimizations/threaded_dispatch");
+	bytecode_optimizer = GLOBAL_GET("ruzta/optimizations/bytecode_optimizer");
+	compact_bytecode = GLOBAL_GET("ruzta/optimizations/compact_bytecode");
+}
+
 void RuztaLanguage::_init() {
+	// Project settings may be set up after construction, as the test runner does.
+	update_optimization_settings();
+
 	// populate global constants
 	int gcc = CoreConstants::get_global_constant_count();
 	for (int i = 0; i < gcc; i++) {
@@ -2245,6 +2417,11 @@ void RuztaLanguage::_init() {
 	}
 #endif	// DEBUG_ENABLED
 
+	// Profiles the whole run, the collapsed stacks are saved on exit.
+	if (!sampling_profile_path.is_empty()) {
+		start_sampling_profiler(sampling_profile_interval_usec);
+	}
+
 #ifdef TESTS_ENABLED
 	RuztaTests::RuztaTestRunner::handle_cmdline();
 #endif	// TESTS_ENABLED
@@ -2262,6 +2439,55 @@ String RuztaLanguage::_get_extension() const {
 	return "rz";
 }
 
+#ifdef RUZTA_OPCODE_STATS
+Dictionary RuztaLanguage::get_opcode_stats() const {
+	return RuztaOpcodeStats::get_report();
+}
+
+void RuztaLanguage::reset_opcode_stats() {
+	RuztaOpcodeStats::reset();
+}
+
+Error RuztaLanguage::save_opcode_stats(const String& p_path) const {
+	Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::WRITE);
+	ERR_FAIL_COND_V_MSG(file.is_null(), FileAccess::get_open_error(), vformat(R"(Could not write opcode stats to "%s".)", p_path));
+	file->store_string(JSON::stringify(get_opcode_stats(), "\t"));
+	return OK;
+}
+#endif
+
+Error RuztaLanguage::start_sampling_profiler(uint64_t p_interval_usec) {
+	return sampling_profiler->start(p_interval_usec);
+}
+
+void RuztaLanguage::stop_sampling_profiler() {
+	sampling_profiler->stop();
+}
+
+bool RuztaLanguage::is_sampling_profiler_running() const {
+	return sampling_profiler->is_running();
+}
+
+Dictionary RuztaLanguage::get_sampling_profile() const {
+	return sampling_profiler->get_report();
+}
+
+String RuztaLanguage::get_sampling_profile_collapsed() const {
+	return sampling_profiler->get_collapsed_stacks();
+}
+
+void RuztaLanguage::reset_sampling_profile() {
+	sampling_profiler->reset();
+}
+
+// Written as collapsed stacks, ready for flame graph tools.
+Error RuztaLanguage::save_sampling_profile(const String& p_path) const {
+	Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::WRITE);
+	ERR_FAIL_COND_V_MSG(file.is_null(), FileAccess::get_open_error(), vformat(R"(Could not write sampling profile to "%s".)", p_path));
+	file->store_string(get_sampling_profile_collapsed());
+	return OK;
+}
+
 void RuztaLanguage::_finish() {
 	if (finishing) {
 		return;
@@ -2271,6 +2497,19 @@ void RuztaLanguage::_finish() {
 	// Clear the cache before parsing the script_list
 	RuztaCache::clear();
 
+#ifdef RUZTA_OPCODE_STATS
+	if (!opcode_stats_path.is_empty()) {
+		save_opcode_stats(opcode_stats_path);
+	}
+#endif
+
+	if (sampling_profiler->is_running()) {
+		sampling_profiler->stop();
+		if (!sampling_profile_path.is_empty()) {
+			save_sampling_profile(sampling_profile_path);
+		}
+	}
+
 	if (finishing) {
 		return;
 	}
@@ -2319,12 +2558,13 @@ void RuztaLanguage::_profiling_start() {
 
 	SelfList<RuztaFunction>* elem = function_list.first();
 	while (elem) {
-		elem->self()->profile.call_count.set(0);
-		elem->self()->profile.self_time.set(0);
-		elem->self()->profile.total_time.set(0);
-		elem->self()->profile.frame_call_count.set(0);
-		elem->self()->profile.frame_self_time.set(0);
-		elem->self()->profile.frame_total_time.set(0);
+		elem->self()->profile.merge_thread_counts(); // Drops what was counted before.
+		elem->self()->profile.call_count = 0;
+		elem->self()->profile.self_time = 0;
+		elem->self()->profile.total_time = 0;
+		elem->self()->profile.frame_call_count = 0;
+		elem->self()->profile.frame_self_time = 0;
+		elem->self()->profile.frame_total_time = 0;
 		elem->self()->profile.last_frame_call_count = 0;
 		elem->self()->profile.last_frame_self_time = 0;
 		elem->self()->profile.last_frame_total_time = 0;
@@ -2365,9 +2605,10 @@ int32_t RuztaLanguage::_profiling_get_accumulated_data(ScriptLanguageExtensionPr
 			break;
 		}
 		int last_non_internal = current;
-		p_info_arr[current].call_count = elem->self()->profile.call_count.get();
-		p_info_arr[current].self_time = elem->self()->profile.self_time.get();
-		p_info_arr[current].total_time = elem->self()->profile.total_time.get();
+		elem->self()->profile.merge_thread_counts();
+		p_info_arr[current].call_count = elem->self()->profile.call_count;
+		p_info_arr[current].self_time = elem->self()->profile.self_time;
+		p_info_arr[current].total_time = elem->self()->profile.total_time;
 		p_info_arr[current].signature = elem->self()->profile.signature;
 		current++;
 
@@ -2658,19 +2899,48 @@ void RuztaLanguage::_reload_tool_script(const Ref<Script>& p_script, bool p_soft
 }
 
 void RuztaLanguage::_frame() {
+	await_scheduler->process_frame();
+
 #ifdef DEBUG_ENABLED
+	if (!debugger_attached && EngineDebugger::get_singleton()->is_active()) {
+		debugger_attached = true;
+
+		// Code compiled before the debugger attached has no OPCODE_LINE to stop at, compile it again.
+		Array scripts;
+		if (should_track_call_stack()) {
+			MutexLock lock(mutex);
+
+			SelfList<RuztaFunction>* elem = function_list.first();
+			while (elem) {
+				Ruzta* scr = elem->self()->get_script();
+				if (!elem->self()->has_line_opcodes() && scr && !scr->get_path().is_empty()) {
+					Ref<Ruzta> root = Ref<Ruzta>(scr->get_root_script());
+					if (!scripts.has(root)) {
+						scripts.push_back(root);
+					}
+				}
+				elem = elem->next();
+			}
+		}
+		if (!scripts.is_empty()) {
+			print_verbose("Ruzta: Debugger attached, recompiling " + itos(scripts.size()) + " scripts for breakpoints");
+			_reload_scripts(scripts, true);
+		}
+	}
+
 	if (profiling) {
 		MutexLock lock(mutex);
 
 		SelfList<RuztaFunction>* elem = function_list.first();
 		while (elem) {
-			elem->self()->profile.last_frame_call_count = elem->self()->profile.frame_call_count.get();
-			elem->self()->profile.last_frame_self_time = elem->self()->profile.frame_self_time.get();
-			elem->self()->profile.last_frame_total_time = elem->self()->profile.frame_total_time.get();
+			elem->self()->profile.merge_thread_counts();
+			elem->self()->profile.last_frame_call_count = elem->self()->profile.frame_call_count;
+			elem->self()->profile.last_frame_self_time = elem->self()->profile.frame_self_time;
+			elem->self()->profile.last_frame_total_time = elem->self()->profile.frame_total_time;
 			elem->self()->profile.last_native_calls = elem->self()->profile.native_calls;
-			elem->self()->profile.frame_call_count.set(0);
-			elem->self()->profile.frame_self_time.set(0);
-			elem->self()->profile.frame_total_time.set(0);
+			elem->self()->profile.frame_call_count = 0;
+			elem->self()->profile.frame_self_time = 0;
+			elem->self()->profile.frame_total_time = 0;
 			elem->self()->profile.native_calls.clear();
 			elem = elem->next();
 		}
@@ -2712,7 +2982,7 @@ PackedStringArray RuztaLanguage::_get_reserved_words() const {
 		"breakpoint",
 		"self",
 		"super",
-		"yield",  // Reserved for potential future use.
+		"yield",
 		// Operators.
 		"and",
 		"as",
@@ -2860,26 +3130,63 @@ Dictionary RuztaLanguage::_get_global_class_name(const String& p_path) const {
 	return result;
 }
 
-thread_local RuztaLanguage::CallLevel* RuztaLanguage::_call_stack = nullptr;
-thread_local uint32_t RuztaLanguage::_call_stack_size = 0;
+Mutex RuztaLanguage::_call_stacks_mutex;
+LocalVector<RuztaLanguage::CallStack*> RuztaLanguage::_call_stacks;
+
+// Releases the stack of its thread when the thread ends.
+struct RuztaLanguage::CallStackOwner {
+	CallStack* call_stack = nullptr;
+
+	~CallStackOwner() {
+		MutexLock lock(_call_stacks_mutex);
+		_call_stacks.erase(call_stack);
+		_call_stack = nullptr;
+		memdelete(call_stack);
+	}
+};
+
+RuztaLanguage::CallStack* RuztaLanguage::_create_call_stack() {
+	// Only constructed here, so only the first push of each thread goes through its initialization guard.
+	static thread_local CallStackOwner owner;
+
+	owner.call_stack = memnew(CallStack);
+	{
+		MutexLock lock(_call_stacks_mutex);
+		_call_stacks.push_back(owner.call_stack);
+	}
+	_call_stack = owner.call_stack;
+	return owner.call_stack;
+}
 
 RuztaLanguage::CallLevel* RuztaLanguage::_get_stack_level(uint32_t p_level) {
-	ERR_FAIL_UNSIGNED_INDEX_V(p_level, _call_stack_size, nullptr);
-	CallLevel* level = _call_stack;	 // Start from top
-	uint32_t level_index = 0;
-	while (p_level > level_index) {
-		level_index++;
-		level = level->prev;
+	ERR_FAIL_UNSIGNED_INDEX_V(p_level, _get_stack_level_count(), nullptr);
+	const uint32_t size = _call_stack->size.load(std::memory_order_relaxed);
+	uint32_t index = size - 1 - p_level; // Level 0 is the top.
+	if (index + CALL_STACK_RING_SIZE < size) {
+		return &_call_stack->spilled[index];
+	}
+	return &_call_stack->levels[index & CALL_STACK_RING_MASK];
+}
+
+void RuztaLanguage::_for_each_call_stack(void (*p_callback)(const CallStack& p_stack, void* p_userdata), void* p_userdata) {
+	// Functions remove themselves from `function_list` under this lock, so the ones on the stacks can't be freed meanwhile.
+	MutexLock lock(mutex);
+	MutexLock stacks_lock(_call_stacks_mutex);
+	for (const CallStack* call_stack : _call_stacks) {
+		p_callback(*call_stack, p_userdata);
 	}
-	return level;
 }
 
 RuztaLanguage::RuztaLanguage() {
 	ERR_FAIL_COND(singleton);
 	singleton = this;
+	await_scheduler = memnew(RuztaAwaitScheduler);
+	sampling_profiler = memnew(RuztaSamplingProfiler);
+
 	strings._init = StringName("_init");
 	strings._static_init = StringName("_static_init");
 	strings._notification = StringName("_notification");
+	strings._ready = StringName("_ready");
 	strings._set = StringName("_set");
 	strings._get = StringName("_get");
 	strings._get_property_list = StringName("_get_property_list");
@@ -2899,6 +3206,15 @@ RuztaLanguage::RuztaLanguage() {
 	_debug_max_call_stack = GLOBAL_DEF_RST(PropertyInfo(Variant::INT, "debug/settings/ruzta/max_call_stack", PROPERTY_HINT_RANGE, "512," + itos(RuztaFunction::MAX_CALL_DEPTH - 1) + ",1"), 1024);
 	track_call_stack = GLOBAL_DEF_RST("debug/settings/ruzta/always_track_call_stacks", false);
 	track_locals = GLOBAL_DEF_RST("debug/settings/ruzta/always_track_local_variables", false);
+	adaptive_quickening = GLOBAL_DEF_RST("ruzta/optimizations/adaptive_quickening", true);
+	threaded_dispatch = GLOBAL_DEF_RST("ruzta/optimizations/threaded_dispatch", false);
+	bytecode_optimizer = GLOBAL_DEF_RST("ruzta/optimizations/bytecode_optimizer", true);
+	compact_bytecode = GLOBAL_DEF_RST("ruzta/optimizations/compact_bytecode", false);
+#ifdef RUZTA_OPCODE_STATS
+	opcode_stats_path = GLOBAL_DEF("ruzta/debug/opcode_stats_path", "");
+#endif
+	sampling_profile_path = GLOBAL_DEF("ruzta/debug/sampling_profile_path", "");
+	sampling_profile_interval_usec = GLOBAL_DEF(PropertyInfo(Variant::INT, "ruzta/debug/sampling_profile_interval_usec", PROPERTY_HINT_RANGE, "100,1000000,1,suffix:us"), 10000);
 
 #ifdef DEBUG_ENABLED
 	track_call_stack = true;
@@ -2929,6 +3245,14 @@ RuztaLanguage::RuztaLanguage() {
 }
 
 RuztaLanguage::~RuztaLanguage() {
+	if (await_scheduler) {
+		memdelete(await_scheduler);
+		await_scheduler = nullptr;
+	}
+	if (sampling_profiler) {
+		memdelete(sampling_profiler);
+		sampling_profiler = nullptr;
+	}
 	singleton = nullptr;
 }
 
@@ -37,6 +37,8 @@
 #include "ruzta_function.h"
 // removed ruzta_cache.h include to fix circular dependency
 class RuztaCache;
+class RuztaAwaitScheduler;
+class RuztaSamplingProfiler;
 // TODO: #include "core/debugger/script_debugger.h" // original: core/debugger/script_debugger.h
 #include <godot_cpp/classes/mutex.hpp>						// original:
 #include <godot_cpp/classes/resource_format_loader.hpp>		// original:
@@ -221,6 +223,7 @@ class Ruzta : public ScriptExtension {
 
 	// Members are just indices to the instantiated script.
 	HashMap<StringName, MemberInfo> member_indices;	 // Includes member info of all base Ruzta classes.
+	uint32_t member_layout_id = 0;					 // Unique per compiled `member_indices`, 0 while not compiled.
 	HashSet<StringName> members;					 // Only members of the current class.
 
 	// Only static variables of the current class.
@@ -229,6 +232,9 @@ class Ruzta : public ScriptExtension {
 
 	HashMap<StringName, Variant> constants;
 	HashMap<StringName, RuztaFunction*> member_functions;
+	HashMap<StringName, RuztaFunction*> method_table;  // Functions of this and all base Ruzta classes, overrides win.
+	Vector<RuztaFunction*> notification_chain;		   // `_notification` of this and all base Ruzta classes, base first.
+	bool method_tables_valid = false;				   // Unset while a base is being recompiled, calls walk the base chain.
 	HashMap<StringName, Ref<Ruzta>> subclasses;
 	HashMap<StringName, MethodInfo> _signals;
 	Dictionary rpc_config;
@@ -297,6 +303,12 @@ class Ruzta : public ScriptExtension {
 
 	Error _static_init();
 	void _static_default_init();  // Initialize static variables with default values based on their types.
+	void _update_method_tables();  // Flatten `member_functions` of the base chain, for this and all subclasses.
+	// Inheriters in other files aren't recompiled with their base, these keep their tables off freed functions.
+	void _invalidate_inheriter_method_tables();
+	void _update_inheriter_method_tables();
+	bool _extends(const Ruzta* p_script) const;
+	static uint32_t new_member_layout_id();  // Keys member and call caches, never 0.
 
 	RBSet<Object*> instances;
 	bool destructing = false;
@@ -345,10 +357,23 @@ class Ruzta : public ScriptExtension {
 
 	Variant callp(const StringName& p_method, const Variant** p_args, GDExtensionInt p_argcount, GDExtensionCallError& r_error);
 
-	static void _bind_methods() { ClassDB::bind_vararg_method(METHOD_FLAGS_DEFAULT, "new", &Ruzta::_new, MethodInfo("new")); }
+	static void _bind_methods();
 
    public:
 	Variant _new(const Variant** p_args, GDExtensionInt p_argcount, GDExtensionCallError& r_error);
+
+	// The language's sampling profiler, exposed to scripts.
+	static Error start_sampling_profiler(int64_t p_interval_usec);
+	static void stop_sampling_profiler();
+	static bool is_sampling_profiler_running();
+	static Dictionary get_sampling_profile();
+	static String get_sampling_profile_collapsed();
+	static void reset_sampling_profile();
+	static Error save_sampling_profile(const String& p_path);
+
+#ifdef DEBUG_ENABLED
+	PackedStringArray get_function_disassembly(const StringName& p_function) const;
+#endif
 #ifdef TOOL_ENABLED
 	virtual bool _editor_can_reload_from_file() override { return true; }
 	virtual void _placeholder_erased(void* p_placeholder) override { placeholders.erase(p_placeholder); }
@@ -466,6 +491,11 @@ class Ruzta : public ScriptExtension {
 	~Ruzta();
 };
 
+struct RuztaFunction::DirectCall {
+	StringName name;
+	Ruzta::UpdatableFuncPtr* function = nullptr;  // nullptr if the method wasn't found, `name` is looked up instead.
+};
+
 class RuztaInstance : public ScriptInstance {
 	friend class Ruzta;
 	friend class RuztaFunction;
@@ -486,6 +516,7 @@ class RuztaInstance : public ScriptInstance {
 	SelfList<RuztaFunctionState>::List pending_func_states;
 
 	void _call_implicit_ready_recursively(Ruzta* p_script);
+	void _notification_base_chain(const Variant** p_args, bool p_reversed);
 
    public:
 	virtual Object* get_owner() { return owner; }
@@ -549,22 +580,51 @@ class RuztaLanguage : public ScriptLanguageExtension {
 		RuztaFunction* function = nullptr;
 		RuztaInstance* instance = nullptr;
 		int* ip = nullptr;
-		int* line = nullptr;
-		CallLevel* prev = nullptr;	// Reverse linked list (stack).
+
+		int get_line() const { return function->get_line(*ip); }
+	};
+
+	// Per-thread shadow stack of the running functions. Entering and leaving a function only writes a slot
+	// of the ring and moves the depth. Deeper recursion spills the outermost levels and restores them on the way out.
+	static constexpr uint32_t CALL_STACK_RING_SIZE = 1024;
+	static constexpr uint32_t CALL_STACK_RING_MASK = CALL_STACK_RING_SIZE - 1;
+	static_assert((CALL_STACK_RING_SIZE & CALL_STACK_RING_MASK) == 0, "The call stack ring size must be a power of 2.");
+
+	// Every thread's stack is registered while the thread lives, so the sampling profiler can read it.
+	// Other threads only read the ring up to the published depth, they may see a level being replaced.
+	struct CallStack {
+		CallLevel levels[CALL_STACK_RING_SIZE];
+		std::atomic<uint32_t> size = 0; // Depth, may exceed the levels kept in the ring. Only written by the owning thread.
+		LocalVector<CallLevel> spilled; // Levels pushed out of the ring, outermost first.
 	};
+	struct CallStackOwner;
 
 	static thread_local int _debug_parse_err_line;
 	static thread_local String _debug_parse_err_file;
 	static thread_local String _debug_error;
 
-	static thread_local CallLevel* _call_stack;
-	static thread_local uint32_t _call_stack_size;
+	// A plain pointer, so using it needs no thread-local initialization guard. Threads only get
+	// a stack, and pay for its ring, once they first enter a function, see `_create_call_stack()`.
+	static inline thread_local CallStack* _call_stack = nullptr;
+	static Mutex _call_stacks_mutex;
+	static LocalVector<CallStack*> _call_stacks;
 	uint32_t _debug_max_call_stack = 0;
 
 	bool track_call_stack = false;
 	bool track_locals = false;
+	bool adaptive_quickening = true;
+	bool threaded_dispatch = false;
+	bool bytecode_optimizer = true;
+	bool compact_bytecode = false;
+#ifdef RUZTA_OPCODE_STATS
+	String opcode_stats_path;
+#endif
+	String sampling_profile_path;
+	uint64_t sampling_profile_interval_usec = 0;
 
+	static CallStack* _create_call_stack();
 	static CallLevel* _get_stack_level(uint32_t p_level);
+	static uint32_t _get_stack_level_count() { return _call_stack ? _call_stack->size.load(std::memory_order_relaxed) : 0; }
 
 	void _add_global(const StringName& p_name, const Variant& p_value);
 	void _remove_global(const StringName& p_name);
@@ -573,6 +633,12 @@ class RuztaLanguage : public ScriptLanguageExtension {
 
 	Mutex mutex;
 
+	RuztaAwaitScheduler* await_scheduler = nullptr;
+	RuztaSamplingProfiler* sampling_profiler = nullptr;
+
+	friend class RuztaSamplingProfiler;
+	void _for_each_call_stack(void (*p_callback)(const CallStack& p_stack, void* p_userdata), void* p_userdata);
+
 	friend class Ruzta;
 
 	SelfList<Ruzta>::List script_list;
@@ -583,6 +649,7 @@ class RuztaLanguage : public ScriptLanguageExtension {
 	bool profiling;
 	bool profile_native_calls;
 	uint64_t script_frame_time;
+	bool debugger_attached = false;
 #endif
 
 	HashMap<String, ObjectID> orphan_subclasses;
@@ -711,7 +778,7 @@ class RuztaLanguage : public ScriptLanguageExtension {
 	bool debug_break(const String& p_error, bool p_allow_continue = true);
 	bool debug_break_parse(const String& p_file, int p_line, const String& p_error);
 
-	_FORCE_INLINE_ void enter_function(CallLevel* call_level, RuztaInstance* p_instance, RuztaFunction* p_function, Variant* p_stack, int* p_ip, int* p_line) {
+	_FORCE_INLINE_ void enter_function(RuztaInstance* p_instance, RuztaFunction* p_function, Variant* p_stack, int* p_ip) {
 		if (!track_call_stack) {
 			return;
 		}
@@ -723,7 +790,13 @@ class RuztaLanguage : public ScriptLanguageExtension {
 		}
 #endif
 
-		if (unlikely(_call_stack_size >= _debug_max_call_stack)) {
+		CallStack* call_stack = _call_stack;
+		if (unlikely(call_stack == nullptr)) {
+			call_stack = _create_call_stack();
+		}
+
+		const uint32_t size = call_stack->size.load(std::memory_order_relaxed);
+		if (unlikely(size >= _debug_max_call_stack)) {
 			_debug_error = vformat("Stack overflow (stack size: %s). Check for infinite recursion in your script.", _debug_max_call_stack);
 
 #ifdef DEBUG_ENABLED
@@ -731,18 +804,18 @@ class RuztaLanguage : public ScriptLanguageExtension {
 				script_debugger->debug(this);
 			}
 #endif
-
-			return;
 		}
 
-		call_level->prev = _call_stack;
-		_call_stack = call_level;
-		call_level->stack = p_stack;
-		call_level->instance = p_instance;
-		call_level->function = p_function;
-		call_level->ip = p_ip;
-		call_level->line = p_line;
-		_call_stack_size++;
+		// Always pushed, so `exit_function()` stays balanced.
+		CallLevel& call_level = call_stack->levels[size & CALL_STACK_RING_MASK];
+		if (unlikely(size >= CALL_STACK_RING_SIZE)) {
+			call_stack->spilled.push_back(call_level);
+		}
+		call_level.stack = p_stack;
+		call_level.instance = p_instance;
+		call_level.function = p_function;
+		call_level.ip = p_ip;
+		call_stack->size.store(size + 1, std::memory_order_release); // Publishes the level to the sampling profiler.
 	}
 
 	_FORCE_INLINE_ void exit_function() {
@@ -757,7 +830,8 @@ class RuztaLanguage : public ScriptLanguageExtension {
 		}
 #endif
 
-		if (unlikely(_call_stack_size == 0)) {
+		CallStack* call_stack = _call_stack;
+		if (unlikely(call_stack == nullptr || call_stack->size.load(std::memory_order_relaxed) == 0)) {
 #ifdef DEBUG_ENABLED
 			if (script_debugger) {
 				_debug_error = "Stack Underflow (Engine Bug)";
@@ -771,25 +845,26 @@ class RuztaLanguage : public ScriptLanguageExtension {
 			return;
 		}
 
-		_call_stack_size--;
-		_call_stack = _call_stack->prev;
+		const uint32_t size = call_stack->size.load(std::memory_order_relaxed) - 1;
+		if (unlikely(size >= CALL_STACK_RING_SIZE)) {
+			// Restored before the depth shrinks, so the ring never shows a level that already returned.
+			uint32_t spilled_index = size - CALL_STACK_RING_SIZE;
+			call_stack->levels[size & CALL_STACK_RING_MASK] = call_stack->spilled[spilled_index];
+			call_stack->spilled.resize(spilled_index);
+		}
+		call_stack->size.store(size, std::memory_order_release);
 	}
 
 	virtual TypedArray<Dictionary> _debug_get_current_stack_info() override {
 		TypedArray<Dictionary> csi;
-		csi.resize(_call_stack_size);
-		CallLevel* cl = _call_stack;
-		uint32_t idx = 0;
-		while (cl) {
+		csi.resize(_get_stack_level_count());
+		for (uint32_t idx = 0; idx < _get_stack_level_count(); idx++) {
+			const CallLevel* cl = _get_stack_level(idx);
 			Dictionary d;
-			d["line"] = *cl->line;
-			if (cl->function) {
-				d["func"] = cl->function->get_name();
-				d["file"] = cl->function->get_script()->get_script_path();
-			}
+			d["line"] = cl->get_line();
+			d["func"] = cl->function->get_name();
+			d["file"] = cl->function->get_script()->get_script_path();
 			csi[idx] = d;
-			idx++;
-			cl = cl->prev;
 		}
 		return csi;
 	}
@@ -798,6 +873,7 @@ class RuztaLanguage : public ScriptLanguageExtension {
 		StringName _init;
 		StringName _static_init;
 		StringName _notification;
+		StringName _ready;
 		StringName _set;
 		StringName _get;
 		StringName _get_property_list;
@@ -810,6 +886,12 @@ class RuztaLanguage : public ScriptLanguageExtension {
 
 	_FORCE_INLINE_ bool should_track_call_stack() const { return track_call_stack; }
 	_FORCE_INLINE_ bool should_track_locals() const { return track_locals; }
+	_FORCE_INLINE_ bool is_adaptive_quickening_enabled() const { return adaptive_quickening; }
+	_FORCE_INLINE_ bool is_threaded_dispatch_enabled() const { return threaded_dispatch; }
+	_FORCE_INLINE_ bool is_bytecode_optimizer_enabled() const { return bytecode_optimizer; }
+	_FORCE_INLINE_ bool is_compact_bytecode_enabled() const { return compact_bytecode; }
+	void update_optimization_settings();
+	_FORCE_INLINE_ RuztaAwaitScheduler* get_await_scheduler() const { return await_scheduler; }
 	_FORCE_INLINE_ int get_global_array_size() const { return global_array.size(); }
 	_FORCE_INLINE_ Variant* get_global_array() { return _global_array; }
 	_FORCE_INLINE_ const HashMap<StringName, int>& get_global_map() const { return globals; }
@@ -818,6 +900,22 @@ class RuztaLanguage : public ScriptLanguageExtension {
 	bool has_any_global_constant(const StringName& p_name) { return named_globals.has(p_name) || globals.has(p_name); }
 	Variant get_any_global_constant(const StringName& p_name);
 
+#ifdef RUZTA_OPCODE_STATS
+	// Opcode and opcode pair execution counts, globally and per function.
+	Dictionary get_opcode_stats() const;
+	void reset_opcode_stats();
+	Error save_opcode_stats(const String& p_path) const;
+#endif
+
+	// Samples the call stacks of all threads every `p_interval_usec`, see `RuztaSamplingProfiler`.
+	Error start_sampling_profiler(uint64_t p_interval_usec);
+	void stop_sampling_profiler();
+	bool is_sampling_profiler_running() const;
+	Dictionary get_sampling_profile() const;
+	String get_sampling_profile_collapsed() const;
+	void reset_sampling_profile();
+	Error save_sampling_profile(const String& p_path) const;
+
 	_FORCE_INLINE_ static RuztaLanguage* get_singleton() { return singleton; }
 
 	virtual String _get_name() const override;
@@ -623,6 +623,11 @@ Error RuztaAnalyzer::resolve_class_inheritance(RuztaParser::ClassNode* p_class,
 		base_class = base_class->base_type.class_type;
 	}
 
+	if (result.kind == RuztaParser::DataType::CLASS && result.class_type->is_final) {
+		push_error(vformat(R"(Cannot extend class "%s" because it is marked as "@final".)", result.to_string()), p_class);
+		return ERR_PARSE_ERROR;
+	}
+
 	p_class->base_type = result;
 	class_type.native_type = result.native_type;
 	p_class->set_datatype(class_type);
@@ -1663,6 +1668,7 @@ void RuztaAnalyzer::resolve_node(RuztaParser::Node* p_node, bool p_is_root) {
 		case RuztaParser::Node::TERNARY_OPERATOR:
 		case RuztaParser::Node::TYPE_TEST:
 		case RuztaParser::Node::UNARY_OPERATOR:
+		case RuztaParser::Node::YIELD:
 			reduce_expression(static_cast<RuztaParser::ExpressionNode*>(p_node), p_is_root);
 			break;
 		case RuztaParser::Node::BREAK:
@@ -1858,7 +1864,16 @@ void RuztaAnalyzer::resolve_function_signature(RuztaParser::FunctionNode* p_func
 			}
 		}
 	} else {
-		if (p_function->return_type != nullptr) {
+		if (p_function->is_generator) {
+			// Calls return the generator itself, whatever the body yields.
+			if (p_function->return_type != nullptr) {
+				push_error("Generator function cannot have an explicit return type.", p_function->return_type);
+			}
+			RuztaParser::DataType return_type;
+			return_type.type_source = RuztaParser::DataType::INFERRED;
+			return_type.kind = RuztaParser::DataType::VARIANT;
+			p_function->set_datatype(return_type);
+		} else if (p_function->return_type != nullptr) {
 			p_function->set_datatype(type_from_metatype(resolve_datatype(p_function->return_type)));
 		} else {
 			// In case the function is not typed, we can safely assume it's a Variant, so it's okay to mark as "inferred" here.
@@ -1869,6 +1884,23 @@ void RuztaAnalyzer::resolve_function_signature(RuztaParser::FunctionNode* p_func
 			p_function->set_datatype(return_type);
 		}
 
+		if (!p_is_lambda) {
+			// Calls to "@inline" functions are compiled in place and calls to "@final" ones don't look the function up, so overriding them would be ignored.
+			RuztaParser::ClassNode* base_class = parser->current_class->base_type.class_type;
+			while (base_class != nullptr) {
+				if (base_class->has_member(function_name)) {
+					resolve_class_member(base_class, function_name, p_function);
+					const RuztaParser::ClassNode::Member& member = base_class->get_member(function_name);
+					if (member.type == RuztaParser::ClassNode::Member::FUNCTION && (member.function->is_inline || member.function->is_final)) {
+						push_error(vformat(R"(Cannot override function "%s()" because it is marked as "%s".)", function_name, member.function->is_final ? "@final" : "@inline"), p_function);
+					}
+					break;
+				}
+				resolve_class_inheritance(base_class, p_function);
+				base_class = base_class->base_type.class_type;
+			}
+		}
+
 #ifdef TOOLS_ENABLED
 		// Check if the function signature matches the parent. If not it's an error since it breaks polymorphism.
 		// Not for the constructor which can vary in signature.
@@ -1973,7 +2005,7 @@ void RuztaAnalyzer::resolve_function_signature(RuztaParser::FunctionNode* p_func
 	}
 
 #ifdef DEBUG_ENABLED
-	if (p_function->return_type == nullptr) {
+	if (p_function->return_type == nullptr && !p_function->is_generator) {
 		parser->push_warning(p_function, RuztaWarning::UNTYPED_DECLARATION, "Function", function_visible_name);
 	}
 #endif	// DEBUG_ENABLED
@@ -2018,9 +2050,17 @@ void RuztaAnalyzer::resolve_function_body(RuztaParser::FunctionNode* p_function,
 	bool previous_static_context = static_context;
 	static_context = p_function->is_static;
 
+	int inferred_locals_from = inferred_locals.size();
 	resolve_suite(p_function->body);
+	promote_inferred_locals(inferred_locals_from);
 
-	if (!p_function->get_datatype().is_hard_type() && p_function->body->get_datatype().is_set()) {
+	if (can_infer_return_type(p_function) && !p_function->is_coroutine && !p_function->inferred_return_conflict && p_function->inferred_return_type.is_set() && p_function->body->has_return) {
+		// Every code path returns a value of the same known type, so callers can rely on it.
+		RuztaParser::DataType return_type = p_function->inferred_return_type;
+		return_type.type_source = RuztaParser::DataType::ANNOTATED_INFERRED;
+		p_function->set_datatype(return_type);
+		p_function->info.return_val = return_type.to_property_info("");
+	} else if (!p_function->get_datatype().is_hard_type() && p_function->body->get_datatype().is_set()) {
 		// Use the suite inferred type if return isn't explicitly set.
 		p_function->set_datatype(p_function->body->get_datatype());
 	} else if (p_function->get_datatype().is_hard_type() && (p_function->get_datatype().kind != RuztaParser::DataType::BUILTIN || p_function->get_datatype().builtin_type != Variant::NIL)) {
@@ -2219,6 +2259,14 @@ void RuztaAnalyzer::resolve_variable(RuztaParser::VariableNode* p_variable, bool
 	static constexpr const char* kind = "variable";
 	resolve_assignable(p_variable, kind);
 
+	if (p_is_local && p_variable->initializer != nullptr && p_variable->initializer->get_datatype().is_hard_type()) {
+		// Untyped locals initialized with a known built-in type are candidates to be compiled as typed.
+		const RuztaParser::DataType& local_type = p_variable->get_datatype();
+		if (local_type.type_source == RuztaParser::DataType::INFERRED && local_type.kind == RuztaParser::DataType::BUILTIN && local_type.builtin_type != Variant::NIL && !local_type.has_container_element_types()) {
+			inferred_locals.push_back(p_variable);
+		}
+	}
+
 #ifdef DEBUG_ENABLED
 	if (p_is_local) {
 		if (p_variable->usages == 0 && !String(p_variable->identifier->name).begins_with("_")) {
@@ -2530,6 +2578,9 @@ void RuztaAnalyzer::resolve_return(RuztaParser::ReturnNode* p_return) {
 	}
 
 	if (p_return->return_value != nullptr) {
+		if (has_expected_type && parser->current_function->is_generator) {
+			push_error("A generator function cannot return a value.", p_return);
+		}
 		bool is_void_function = has_expected_type && expected_type.is_hard_type() && expected_type.kind == RuztaParser::DataType::BUILTIN && expected_type.builtin_type == Variant::NIL;
 		bool is_call = p_return->return_value->type == RuztaParser::Node::CALL;
 		if (is_void_function && is_call) {
@@ -2594,6 +2645,10 @@ void RuztaAnalyzer::resolve_return(RuztaParser::ReturnNode* p_return) {
 	}
 
 	p_return->set_datatype(result);
+
+	if (has_expected_type && can_infer_return_type(parser->current_function)) {
+		update_inferred_return_type(parser->current_function, p_return);
+	}
 }
 
 void RuztaAnalyzer::reduce_expression(RuztaParser::ExpressionNode* p_expression, bool p_is_root) {
@@ -2662,6 +2717,9 @@ void RuztaAnalyzer::reduce_expression(RuztaParser::ExpressionNode* p_expression,
 		case RuztaParser::Node::UNARY_OPERATOR:
 			reduce_unary_op(static_cast<RuztaParser::UnaryOpNode*>(p_expression));
 			break;
+		case RuztaParser::Node::YIELD:
+			reduce_yield(static_cast<RuztaParser::YieldNode*>(p_expression));
+			break;
 		// Non-expressions. Here only to make sure new nodes aren't forgotten.
 		case RuztaParser::Node::NONE:
 		case RuztaParser::Node::ANNOTATION:
@@ -2871,6 +2929,20 @@ void RuztaAnalyzer::reduce_assignment(RuztaParser::AssignmentNode* p_assignment)
 
 	reduce_expression(p_assignment->assignee);
 
+	{
+		// Parameters that are never written can share the caller's value instead of copying it.
+		RuztaParser::ExpressionNode* base = p_assignment->assignee;
+		while (base && base->type == RuztaParser::Node::SUBSCRIPT) {
+			base = static_cast<RuztaParser::SubscriptNode*>(base)->base;
+		}
+		if (base && base->type == RuztaParser::Node::IDENTIFIER) {
+			RuztaParser::IdentifierNode* id = static_cast<RuztaParser::IdentifierNode*>(base);
+			if (id->source == RuztaParser::IdentifierNode::FUNCTION_PARAMETER && id->parameter_source) {
+				id->parameter_source->is_written = true;
+			}
+		}
+	}
+
 #ifdef DEBUG_ENABLED
 	{
 		bool is_subscript = false;
@@ -3044,6 +3116,8 @@ void RuztaAnalyzer::reduce_assignment(RuztaParser::AssignmentNode* p_assignment)
 		downgrade_node_type_source(p_assignment->assigned_value);
 	}
 
+	track_inferred_local_assignment(p_assignment);
+
 #ifdef DEBUG_ENABLED
 	if (assignee_type.is_hard_type() && assignee_type.builtin_type == Variant::INT && assigned_value_type.builtin_type == Variant::FLOAT) {
 		parser->push_warning(p_assignment->assigned_value, RuztaWarning::NARROWING_CONVERSION);
@@ -3093,6 +3167,17 @@ void RuztaAnalyzer::reduce_await(RuztaParser::AwaitNode* p_await) {
 #endif	// DEBUG_ENABLED
 }
 
+void RuztaAnalyzer::reduce_yield(RuztaParser::YieldNode* p_yield) {
+	if (p_yield->value) {
+		reduce_expression(p_yield->value);
+	}
+
+	// Evaluates to whatever the generator is resumed with, which is `null` when iterating.
+	RuztaParser::DataType yield_type;
+	yield_type.kind = RuztaParser::DataType::VARIANT;
+	p_yield->set_datatype(yield_type);
+}
+
 void RuztaAnalyzer::reduce_binary_op(RuztaParser::BinaryOpNode* p_binary_op) {
 	reduce_expression(p_binary_op->left_operand);
 	reduce_expression(p_binary_op->right_operand);
@@ -3551,6 +3636,36 @@ void RuztaAnalyzer::reduce_call(RuztaParser::CallNode* p_call, bool p_is_await,
 			reduce_expression(subscript->base);
 			base_type = subscript->base->get_datatype();
 			is_self = subscript->base->type == RuztaParser::Node::SELF;
+
+			// Methods of value types may change the value in place, so the parameter needs its own copy.
+			RuztaParser::ExpressionNode* base = subscript->base;
+			while (base->type == RuztaParser::Node::SUBSCRIPT && static_cast<RuztaParser::SubscriptNode*>(base)->base) {
+				base = static_cast<RuztaParser::SubscriptNode*>(base)->base;
+			}
+			if (base->type == RuztaParser::Node::IDENTIFIER) {
+				RuztaParser::IdentifierNode* id = static_cast<RuztaParser::IdentifierNode*>(base);
+				if (id->source == RuztaParser::IdentifierNode::FUNCTION_PARAMETER && id->parameter_source) {
+					const RuztaParser::DataType param_type = id->get_datatype();
+					bool is_shared = false;
+					if (param_type.is_hard_type()) {
+						switch (param_type.kind) {
+							case RuztaParser::DataType::NATIVE:
+							case RuztaParser::DataType::SCRIPT:
+							case RuztaParser::DataType::CLASS:
+								is_shared = true;
+								break;
+							case RuztaParser::DataType::BUILTIN:
+								is_shared = param_type.builtin_type == Variant::ARRAY || param_type.builtin_type == Variant::DICTIONARY || param_type.builtin_type == Variant::OBJECT;
+								break;
+							default:
+								break;
+						}
+					}
+					if (!is_shared) {
+						id->parameter_source->is_written = true;
+					}
+				}
+			}
 		}
 	} else {
 		// Invalid call. Error already sent in parser.
@@ -5742,6 +5857,7 @@ bool RuztaAnalyzer::get_function_signature(RuztaParser::Node* p_source, bool p_i
 	}
 
 	RuztaParser::ClassNode* base_class = p_base_type.class_type;
+	RuztaParser::ClassNode* found_function_class = nullptr;
 	RuztaParser::FunctionNode* found_function = nullptr;
 
 	while (found_function == nullptr && base_class != nullptr) {
@@ -5753,6 +5869,7 @@ bool RuztaAnalyzer::get_function_signature(RuztaParser::Node* p_source, bool p_i
 			}
 
 			resolve_class_member(base_class, function_name, p_source);
+			found_function_class = base_class;
 			found_function = base_class->get_member(function_name).function;
 		}
 
@@ -5776,6 +5893,11 @@ bool RuztaAnalyzer::get_function_signature(RuztaParser::Node* p_source, bool p_i
 		if (found_function->is_vararg()) {
 			r_method_flags.set_flag(METHOD_FLAG_VARARG);
 		}
+		// Only from function bodies, when the class interfaces are already resolved.
+		bool in_function_body = parser->current_function != nullptr && parser->current_function->resolved_body;
+		if (!p_is_constructor && in_function_body && !found_function->resolved_body && can_infer_return_type(found_function)) {
+			resolve_inferred_return_type(found_function_class, found_function, p_source);
+		}
 		r_return_type = p_is_constructor ? p_base_type : found_function->get_datatype();
 		r_return_type.is_meta_type = false;
 		r_return_type.is_coroutine = found_function->is_coroutine;
@@ -6279,6 +6401,127 @@ void RuztaAnalyzer::mark_lambda_use_self() {
 	}
 }
 
+void RuztaAnalyzer::track_inferred_local_assignment(const RuztaParser::AssignmentNode* p_assignment) {
+	if (p_assignment->assignee->type != RuztaParser::Node::IDENTIFIER) {
+		return;
+	}
+	const RuztaParser::IdentifierNode* id = static_cast<const RuztaParser::IdentifierNode*>(p_assignment->assignee);
+	if (id->source != RuztaParser::IdentifierNode::LOCAL_VARIABLE || id->variable_source == nullptr || id->variable_source->inferred_type_conflict) {
+		return;
+	}
+
+	const RuztaParser::DataType local_type = id->variable_source->get_datatype();
+	if (local_type.type_source != RuztaParser::DataType::INFERRED || local_type.kind != RuztaParser::DataType::BUILTIN) {
+		return;
+	}
+
+	// The local keeps its type only if every value stored in it is statically known to have that same type.
+	Variant::Type result_type = Variant::NIL;
+	const RuztaParser::DataType value_type = p_assignment->assigned_value->get_datatype();
+	if (value_type.is_hard_type() && value_type.kind == RuztaParser::DataType::BUILTIN) {
+		if (p_assignment->operation == RuztaParser::AssignmentNode::OP_NONE) {
+			result_type = value_type.builtin_type;
+		} else {
+			result_type = RuztaVariantExtension::get_operator_return_type(p_assignment->variant_op, local_type.builtin_type, value_type.builtin_type);
+		}
+	}
+	if (result_type != local_type.builtin_type) {
+		id->variable_source->inferred_type_conflict = true;
+	}
+}
+
+void RuztaAnalyzer::promote_inferred_locals(int p_from) {
+	// Called once the whole body (including lambdas) is resolved, so all assignments have been seen.
+	for (int i = p_from; i < inferred_locals.size(); i++) {
+		RuztaParser::VariableNode* variable = inferred_locals[i];
+		if (variable->inferred_type_conflict) {
+			continue;
+		}
+		RuztaParser::DataType type = variable->get_datatype();
+		type.type_source = RuztaParser::DataType::ANNOTATED_INFERRED;
+		variable->set_datatype(type);
+	}
+	inferred_locals.resize(p_from);
+}
+
+bool RuztaAnalyzer::can_infer_return_type(const RuztaParser::FunctionNode* p_function) {
+	// Only static functions: calls to them can't be dispatched to an override with a different return type.
+	return p_function != nullptr && p_function->is_static && p_function->return_type == nullptr && p_function->source_lambda == nullptr && !p_function->is_generator && !p_function->is_abstract;
+}
+
+void RuztaAnalyzer::update_inferred_return_type(RuztaParser::FunctionNode* p_function, const RuztaParser::ReturnNode* p_return) {
+	if (p_function->inferred_return_conflict) {
+		return;
+	}
+	if (p_return->return_value == nullptr) {
+		p_function->inferred_return_conflict = true;
+		return;
+	}
+
+	// A self-recursive call in return position yields a value produced by some other `return` of this function,
+	// so it doesn't constrain the type. This is the fixed point of the return type with respect to recursion.
+	if (p_return->return_value->type == RuztaParser::Node::CALL) {
+		const RuztaParser::CallNode* call = static_cast<const RuztaParser::CallNode*>(p_return->return_value);
+		if (!call->is_super && call->callee != nullptr && call->callee->type == RuztaParser::Node::IDENTIFIER && call->function_name == p_function->identifier->name &&
+				parser->current_class->has_member(call->function_name)) {
+			const RuztaParser::ClassNode::Member& member = parser->current_class->get_member(call->function_name);
+			if (member.type == RuztaParser::ClassNode::Member::FUNCTION && member.function == p_function) {
+				return;
+			}
+		}
+	}
+
+	RuztaParser::DataType return_type = p_return->return_value->get_datatype();
+	if (!return_type.is_hard_type() || return_type.is_variant() || return_type.is_meta_type || return_type.is_coroutine ||
+			(return_type.kind == RuztaParser::DataType::BUILTIN && return_type.builtin_type == Variant::NIL)) {
+		p_function->inferred_return_conflict = true;
+		return;
+	}
+	// Typed containers are still valid values for the untyped container type.
+	return_type.container_element_types.clear();
+	return_type.is_constant = false;
+	return_type.is_read_only = false;
+
+	if (!p_function->inferred_return_type.is_set()) {
+		p_function->inferred_return_type = return_type;
+	} else if (p_function->inferred_return_type != return_type) {
+		p_function->inferred_return_conflict = true;
+	}
+}
+
+void RuztaAnalyzer::resolve_inferred_return_type(RuztaParser::ClassNode* p_class, RuztaParser::FunctionNode* p_function, const RuztaParser::Node* p_source) {
+	// The return type of a function without annotation is only known after its body is resolved, so do it ahead of time.
+	if (!parser->has_class(p_class)) {
+		Ref<RuztaParserRef> parser_ref = ensure_cached_external_parser_for_class(p_class, nullptr, "Trying to infer return type of external function", p_source);
+		if (parser_ref.is_null() || parser_ref->raise_status(RuztaParserRef::INTERFACE_SOLVED) != OK) {
+			return;
+		}
+		parser_ref->get_analyzer()->resolve_inferred_return_type(p_class, p_function, nullptr);
+		return;
+	}
+
+	for (const RuztaParser::ClassNode::Member& member : p_class->members) {
+		if (member.get_datatype().is_resolving()) {
+			// The interface is still being resolved further up the stack, don't risk a cyclic reference.
+			return;
+		}
+	}
+
+	RuztaParser::ClassNode* previous_class = parser->current_class;
+	RuztaParser::LambdaNode* previous_lambda = current_lambda;
+	List<RuztaParser::LambdaNode*> previous_pending_lambdas = pending_body_resolution_lambdas;
+	parser->current_class = p_class;
+	current_lambda = nullptr;
+	pending_body_resolution_lambdas.clear();
+
+	resolve_class_interface(p_class, p_source);
+	resolve_function_body(p_function);
+
+	parser->current_class = previous_class;
+	current_lambda = previous_lambda;
+	pending_body_resolution_lambdas = previous_pending_lambdas;
+}
+
 void RuztaAnalyzer::resolve_pending_lambda_bodies() {
 	if (pending_body_resolution_lambdas.is_empty()) {
 		return;
@@ -6313,6 +6556,7 @@ void RuztaAnalyzer::resolve_pending_lambda_bodies() {
 				RuztaParser::ParameterNode* capture_param = parser->alloc_node<RuztaParser::ParameterNode>();
 				capture_param->identifier = capture;
 				capture_param->usages = capture->usages;
+				capture_param->is_written = true; // Not tracked, lambda callables never lend their captures.
 				capture_param->set_datatype(capture->get_datatype());
 
 				lambda->function->parameters.write[i] = capture_param;
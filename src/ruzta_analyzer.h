@@ -56,6 +56,7 @@ class RuztaAnalyzer {
 	const RuztaParser::EnumNode *current_enum = nullptr;
 	RuztaParser::LambdaNode *current_lambda = nullptr;
 	List<RuztaParser::LambdaNode *> pending_body_resolution_lambdas;
+	Vector<RuztaParser::VariableNode *> inferred_locals; // Untyped locals that may be promoted to their inferred type.
 	HashMap<const RuztaParser::ClassNode *, Ref<RuztaParserRef>> external_class_parser_cache;
 	bool static_context = false;
 
@@ -117,6 +118,7 @@ class RuztaAnalyzer {
 	void reduce_ternary_op(RuztaParser::TernaryOpNode *p_ternary_op, bool p_is_root = false);
 	void reduce_type_test(RuztaParser::TypeTestNode *p_type_test);
 	void reduce_unary_op(RuztaParser::UnaryOpNode *p_unary_op);
+	void reduce_yield(RuztaParser::YieldNode *p_yield);
 
 	Variant make_expression_reduced_value(RuztaParser::ExpressionNode *p_expression, bool &is_reduced);
 	Variant make_array_reduced_value(RuztaParser::ArrayNode *p_array, bool &is_reduced);
@@ -143,6 +145,11 @@ class RuztaAnalyzer {
 	void push_error(const String &p_message, const RuztaParser::Node *p_origin = nullptr);
 	void mark_node_unsafe(const RuztaParser::Node *p_node);
 	void downgrade_node_type_source(RuztaParser::Node *p_node);
+	void track_inferred_local_assignment(const RuztaParser::AssignmentNode *p_assignment);
+	void promote_inferred_locals(int p_from);
+	static bool can_infer_return_type(const RuztaParser::FunctionNode *p_function);
+	void update_inferred_return_type(RuztaParser::FunctionNode *p_function, const RuztaParser::ReturnNode *p_return);
+	void resolve_inferred_return_type(RuztaParser::ClassNode *p_class, RuztaParser::FunctionNode *p_function, const RuztaParser::Node *p_source);
 	void mark_lambda_use_self();
 	void resolve_pending_lambda_bodies();
 	bool class_exists(const StringName &p_class) const;
@@ -0,0 +1,318 @@
+/**************************************************************************/
+/*  ruzta_await_scheduler.cpp                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                RUZTA                                   */
+/*                    https://seremtitus.co.ke/ruzta                      */
+/**************************************************************************/
+//* Copyright (c) 2025-present Ruzta contributors (see AUTHORS.md).        */
+/* Copyright (c) 2014-present Godot Engine contributors                   */
+/*                                             (see OG_AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "ruzta_await_scheduler.h"
+
+#include "ruzta_function.h"
+
+#include <godot_cpp/classes/os.hpp> // original: core/os/os.h
+#include <godot_cpp/core/class_db.hpp> // original: core/object/class_db.h
+#include <godot_cpp/core/math.hpp> // original: core/math/math_funcs.h
+#include <godot_cpp/core/mutex_lock.hpp> // original:
+#include <godot_cpp/variant/callable_custom.hpp> // original:
+
+// Connected once to every signal some function is waiting on.
+class RuztaAwaitCallable : public CallableCustom {
+	RuztaAwaitScheduler *scheduler = nullptr;
+	RuztaAwaitScheduler::SignalKey key;
+	uint32_t h = 0;
+
+	// Both functions are only ever handed callables of this type, the hash alone may collide.
+	static bool compare_equal(const CallableCustom *p_a, const CallableCustom *p_b) {
+		const RuztaAwaitCallable *a = static_cast<const RuztaAwaitCallable *>(p_a);
+		const RuztaAwaitCallable *b = static_cast<const RuztaAwaitCallable *>(p_b);
+		return a->scheduler == b->scheduler && a->key == b->key;
+	}
+
+	static bool compare_less(const CallableCustom *p_a, const CallableCustom *p_b) {
+		const RuztaAwaitCallable *a = static_cast<const RuztaAwaitCallable *>(p_a);
+		const RuztaAwaitCallable *b = static_cast<const RuztaAwaitCallable *>(p_b);
+		if (a->h != b->h) {
+			return a->h < b->h;
+		}
+		if (a->scheduler != b->scheduler) {
+			return a->scheduler < b->scheduler;
+		}
+		if (a->key.object != b->key.object) {
+			return (uint64_t)a->key.object < (uint64_t)b->key.object;
+		}
+		return String(a->key.name) < String(b->key.name);
+	}
+
+public:
+	uint32_t hash() const override { return h; }
+	String get_as_text() const override { return "RuztaAwaitScheduler::" + String(key.name) + " (await)"; }
+	CompareEqualFunc get_compare_equal_func() const override { return compare_equal; }
+	CompareLessFunc get_compare_less_func() const override { return compare_less; }
+	ObjectID get_object() const override { return ObjectID(scheduler->get_instance_id()); }
+
+	int get_argument_count(bool &r_is_valid) const override {
+		r_is_valid = false;
+		return 0;
+	}
+
+	void call(const Variant **p_arguments, int p_argcount, Variant &r_return_value, GDExtensionCallError &r_call_error) const override {
+		r_call_error.error = GDExtensionCallErrorType::GDEXTENSION_CALL_OK;
+
+		Variant arg;
+		if (p_argcount == 1) {
+			arg = *p_arguments[0];
+		} else if (p_argcount > 1) {
+			Array args;
+			for (int i = 0; i < p_argcount; i++) {
+				args.push_back(*p_arguments[i]);
+			}
+			arg = args;
+		}
+
+		scheduler->_signal_fired(key, arg);
+		r_return_value = Variant();
+	}
+
+	RuztaAwaitCallable(RuztaAwaitScheduler *p_scheduler, const RuztaAwaitScheduler::SignalKey &p_key) {
+		scheduler = p_scheduler;
+		key = p_key;
+		h = hash_murmur3_one_64(p_scheduler->get_instance_id(), RuztaAwaitScheduler::SignalKeyHasher::hash(p_key));
+	}
+};
+
+/////////////////////
+
+void RuztaSleepTimer::_bind_methods() {
+	ADD_SIGNAL(MethodInfo("timeout"));
+}
+
+/////////////////////
+
+void RuztaAwaitScheduler::_insert_timer(const Ref<RuztaSleepTimer> &p_timer) {
+	uint64_t deadline = MAX(p_timer->deadline, current_tick + 1);
+	uint64_t delta = deadline - current_tick;
+
+	int level = 0;
+	while (level < WHEEL_LEVELS - 1 && delta >= (uint64_t(1) << (WHEEL_BITS * (level + 1)))) {
+		level++;
+	}
+	if (delta >= (uint64_t(1) << (WHEEL_BITS * WHEEL_LEVELS))) {
+		// Too far away, park it in the last slot the wheel can reach.
+		deadline = current_tick + (uint64_t(1) << (WHEEL_BITS * WHEEL_LEVELS)) - 1;
+	}
+
+	wheel[level][(deadline >> (WHEEL_BITS * level)) & WHEEL_MASK].push_back(p_timer);
+}
+
+void RuztaAwaitScheduler::_advance_timers(uint64_t p_now, LocalVector<Ref<RuztaSleepTimer>> &r_expired) {
+	while (timer_count > 0 && current_tick < p_now) {
+		current_tick++;
+
+		// Cascade the coarser levels first, their timers may land in the slot due now.
+		for (int level = WHEEL_LEVELS - 1; level > 0; level--) {
+			if ((current_tick & ((uint64_t(1) << (WHEEL_BITS * level)) - 1)) != 0) {
+				continue;
+			}
+			LocalVector<Ref<RuztaSleepTimer>> &slot = wheel[level][(current_tick >> (WHEEL_BITS * level)) & WHEEL_MASK];
+			for (uint32_t i = 0; i < slot.size(); i++) {
+				_insert_timer(slot[i]);
+			}
+			slot.clear();
+		}
+
+		LocalVector<Ref<RuztaSleepTimer>> &due = wheel[0][current_tick & WHEEL_MASK];
+		for (uint32_t i = 0; i < due.size(); i++) {
+			r_expired.push_back(due[i]);
+		}
+		timer_count -= due.size();
+		due.clear();
+	}
+
+	// Nothing is pending, the wheel can jump straight to the present.
+	current_tick = MAX(current_tick, p_now);
+}
+
+void RuztaAwaitScheduler::_signal_fired(const SignalKey &p_key, const Variant &p_arg) {
+	LocalVector<Ref<RuztaFunctionState>> waiters;
+	{
+		MutexLock lock(mutex);
+		HashMap<SignalKey, LocalVector<Ref<RuztaFunctionState>>, SignalKeyHasher>::Iterator E = signal_waiters.find(p_key);
+		if (!E) {
+			return;
+		}
+		// The connection was one-shot, whoever awaits again during the resumes waits for the next emission.
+		waiters = E->value;
+		signal_waiters.remove(E);
+	}
+
+	for (uint32_t i = 0; i < waiters.size(); i++) {
+		_resume(waiters[i], p_arg);
+	}
+}
+
+void RuztaAwaitScheduler::_resume(const Ref<RuztaFunctionState> &p_state, const Variant &p_arg) {
+	// The script or instance may have gone away while waiting, just drop the state then.
+	if (p_state->is_valid(true)) {
+		p_state->resume(p_arg);
+	}
+}
+
+Signal RuztaAwaitScheduler::sleep(double p_seconds) {
+	Ref<RuztaSleepTimer> timer;
+	timer.instantiate();
+
+	uint64_t now = OS::get_singleton()->get_ticks_msec();
+	timer->deadline = now + (uint64_t)MAX(Math::round(p_seconds * 1000.0), 0.0);
+
+	MutexLock lock(mutex);
+	if (timer_count == 0) {
+		current_tick = now;
+	}
+	_insert_timer(timer);
+	timer_count++;
+
+	return Signal(timer.ptr(), StringName("timeout"));
+}
+
+Signal RuztaAwaitScheduler::next_frame() {
+	return Signal(this, StringName("frame"));
+}
+
+Error RuztaAwaitScheduler::await_signal(const Signal &p_signal, const Ref<RuztaFunctionState> &p_state) {
+	Object *object = p_signal.get_object();
+	ERR_FAIL_NULL_V(object, ERR_INVALID_PARAMETER);
+
+	if (object == this) {
+		MutexLock lock(mutex);
+		frame_waiters.push_back(p_state);
+		return OK;
+	}
+
+	RuztaSleepTimer *timer = Object::cast_to<RuztaSleepTimer>(object);
+	if (timer) {
+		MutexLock lock(mutex);
+		if (timer->expired) {
+			// Awaiting a timer stored past its deadline, don't wait forever.
+			frame_waiters.push_back(p_state);
+		} else {
+			timer->waiters.push_back(p_state);
+		}
+		return OK;
+	}
+
+	SignalKey key;
+	key.object = p_signal.get_object_id();
+	key.name = p_signal.get_name();
+
+	MutexLock lock(mutex);
+	HashMap<SignalKey, LocalVector<Ref<RuztaFunctionState>>, SignalKeyHasher>::Iterator E = signal_waiters.find(key);
+	if (E) {
+		E->value.push_back(p_state);
+		return OK;
+	}
+
+	Error err = (Error)p_signal.connect(Callable(memnew(RuztaAwaitCallable(this, key))), Object::CONNECT_ONE_SHOT);
+	if (err != OK) {
+		return err;
+	}
+	signal_waiters[key].push_back(p_state);
+	return OK;
+}
+
+void RuztaAwaitScheduler::process_frame() {
+	LocalVector<Ref<RuztaFunctionState>> frame;
+	LocalVector<Ref<RuztaSleepTimer>> expired;
+	{
+		MutexLock lock(mutex);
+		frame = frame_waiters;
+		frame_waiters.clear();
+
+		_advance_timers(OS::get_singleton()->get_ticks_msec(), expired);
+		for (uint32_t i = 0; i < expired.size(); i++) {
+			expired[i]->expired = true;
+		}
+
+		// Signals of freed objects will never fire, release whoever waits on them.
+		LocalVector<SignalKey> gone;
+		for (const KeyValue<SignalKey, LocalVector<Ref<RuztaFunctionState>>> &E : signal_waiters) {
+			if (!ObjectDB::get_instance(E.key.object)) {
+				gone.push_back(E.key);
+			}
+		}
+		for (uint32_t i = 0; i < gone.size(); i++) {
+			signal_waiters.erase(gone[i]);
+		}
+	}
+
+	for (uint32_t i = 0; i < frame.size(); i++) {
+		_resume(frame[i], Variant());
+	}
+	emit_signal(StringName("frame"));
+
+	for (uint32_t i = 0; i < expired.size(); i++) {
+		RuztaSleepTimer *timer = expired[i].ptr();
+		LocalVector<Ref<RuztaFunctionState>> waiters;
+		{
+			MutexLock lock(mutex);
+			waiters = timer->waiters;
+			timer->waiters.clear();
+		}
+		for (uint32_t j = 0; j < waiters.size(); j++) {
+			_resume(waiters[j], Variant());
+		}
+		timer->emit_signal(StringName("timeout"));
+	}
+}
+
+void RuztaAwaitScheduler::clear() {
+	MutexLock lock(mutex);
+	for (int level = 0; level < WHEEL_LEVELS; level++) {
+		for (int slot = 0; slot < WHEEL_SLOTS; slot++) {
+			wheel[level][slot].clear();
+		}
+	}
+	timer_count = 0;
+	frame_waiters.clear();
+	signal_waiters.clear();
+}
+
+void RuztaAwaitScheduler::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("sleep", "seconds"), &RuztaAwaitScheduler::sleep);
+	ClassDB::bind_method(D_METHOD("next_frame"), &RuztaAwaitScheduler::next_frame);
+	ClassDB::bind_method(D_METHOD("process_frame"), &RuztaAwaitScheduler::process_frame);
+
+	ADD_SIGNAL(MethodInfo("frame"));
+}
+
+RuztaAwaitScheduler::RuztaAwaitScheduler() {
+	current_tick = OS::get_singleton()->get_ticks_msec();
+}
+
+RuztaAwaitScheduler::~RuztaAwaitScheduler() {
+	clear();
+}
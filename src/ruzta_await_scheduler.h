@@ -0,0 +1,119 @@
+/**************************************************************************/
+/*  ruzta_await_scheduler.h                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                RUZTA                                   */
+/*                    https://seremtitus.co.ke/ruzta                      */
+/**************************************************************************/
+//* Copyright (c) 2025-present Ruzta contributors (see AUTHORS.md).        */
+/* Copyright (c) 2014-present Godot Engine contributors                   */
+/*                                             (see OG_AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <godot_cpp/classes/mutex.hpp> // original: core/os/mutex.h
+#include <godot_cpp/classes/object.hpp> // original: core/object/object.h
+#include <godot_cpp/classes/ref_counted.hpp> // original: core/object/ref_counted.h
+#include <godot_cpp/templates/hash_map.hpp> // original: core/templates/hash_map.h
+#include <godot_cpp/templates/hashfuncs.hpp> // original: core/templates/hashfuncs.h
+#include <godot_cpp/templates/local_vector.hpp> // original: core/templates/local_vector.h
+#include <godot_cpp/variant/signal.hpp> // original: core/variant/variant.h
+
+using namespace godot;
+
+class RuztaFunctionState;
+
+// Returned by `RuztaAwaitScheduler.sleep()` as its `timeout` signal. Coroutines awaiting it are kept
+// in the scheduler's timer wheel rather than connected to the signal, which is
+// still emitted on expiry for regular connections.
+class RuztaSleepTimer : public RefCounted {
+	GDCLASS(RuztaSleepTimer, RefCounted);
+	friend class RuztaAwaitScheduler;
+
+	uint64_t deadline = 0;
+	bool expired = false;
+	LocalVector<Ref<RuztaFunctionState>> waiters;
+
+protected:
+	static void _bind_methods();
+};
+
+// Keeps suspended functions until whatever they await happens, and resumes them.
+// Owned by RuztaLanguage and advanced once per frame from `RuztaLanguage::_frame()`.
+class RuztaAwaitScheduler : public Object {
+	GDCLASS(RuztaAwaitScheduler, Object);
+	friend class RuztaAwaitCallable;
+
+public:
+	struct SignalKey {
+		ObjectID object;
+		StringName name;
+
+		bool operator==(const SignalKey &p_key) const { return object == p_key.object && name == p_key.name; }
+	};
+
+	struct SignalKeyHasher {
+		static _FORCE_INLINE_ uint32_t hash(const SignalKey &p_key) { return hash_murmur3_one_64((uint64_t)p_key.object, p_key.name.hash()); }
+	};
+
+private:
+	// Hierarchical timer wheel with one tick per millisecond. Each level spans
+	// WHEEL_SLOTS times the level below it, and its slots are cascaded down as
+	// the lower level wraps around. Deadlines beyond the last level are parked
+	// in it and re-filed on every pass.
+	static constexpr int WHEEL_BITS = 6;
+	static constexpr int WHEEL_SLOTS = 1 << WHEEL_BITS;
+	static constexpr uint64_t WHEEL_MASK = WHEEL_SLOTS - 1;
+	static constexpr int WHEEL_LEVELS = 4;
+
+	LocalVector<Ref<RuztaSleepTimer>> wheel[WHEEL_LEVELS][WHEEL_SLOTS];
+	uint64_t current_tick = 0;
+	uint32_t timer_count = 0;
+
+	LocalVector<Ref<RuztaFunctionState>> frame_waiters;
+	// One one-shot connection per awaited signal, however many functions wait on it.
+	HashMap<SignalKey, LocalVector<Ref<RuztaFunctionState>>, SignalKeyHasher> signal_waiters;
+
+	Mutex mutex;
+
+	void _insert_timer(const Ref<RuztaSleepTimer> &p_timer);
+	void _advance_timers(uint64_t p_now, LocalVector<Ref<RuztaSleepTimer>> &r_expired);
+	void _signal_fired(const SignalKey &p_key, const Variant &p_arg);
+	static void _resume(const Ref<RuztaFunctionState> &p_state, const Variant &p_arg);
+
+protected:
+	static void _bind_methods();
+
+public:
+	Signal sleep(double p_seconds);
+	Signal next_frame();
+
+	// Suspends `p_state` until `p_signal` is emitted, then resumes it with the signal arguments.
+	Error await_signal(const Signal &p_signal, const Ref<RuztaFunctionState> &p_state);
+	void process_frame();
+	void clear();
+
+	RuztaAwaitScheduler();
+	~RuztaAwaitScheduler();
+};
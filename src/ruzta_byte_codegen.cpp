@@ -44,9 +44,36 @@ uint32_t RuztaByteCodeGenerator::add_parameter(const StringName &p_name, bool p_
 	return add_local(p_name, p_type);
 }
 
+// Values of these types live inside the Variant and need no destructor.
+static bool _is_trivial_type(Variant::Type p_type) {
+	switch (p_type) {
+		case Variant::BOOL:
+		case Variant::INT:
+		case Variant::FLOAT:
+		case Variant::VECTOR2:
+		case Variant::VECTOR2I:
+		case Variant::RECT2:
+		case Variant::RECT2I:
+		case Variant::VECTOR3:
+		case Variant::VECTOR3I:
+		case Variant::VECTOR4:
+		case Variant::VECTOR4I:
+		case Variant::PLANE:
+		case Variant::QUATERNION:
+		case Variant::COLOR:
+		case Variant::RID:
+			return true;
+		default:
+			return false;
+	}
+}
+
 uint32_t RuztaByteCodeGenerator::add_local(const StringName &p_name, const RuztaDataType &p_type) {
 	int stack_pos = locals.size() + RuztaFunction::FIXED_ADDRESSES_MAX;
 	locals.push_back(StackSlot(p_type.builtin_type, p_type.can_contain_object()));
+	if (p_type.kind != RuztaDataType::BUILTIN || !_is_trivial_type(p_type.builtin_type)) {
+		nontrivial_locals.insert(stack_pos);
+	}
 	add_stack_identifier(p_name, stack_pos);
 	return stack_pos;
 }
@@ -150,7 +177,7 @@ void RuztaByteCodeGenerator::pop_temporary() {
 
 void RuztaByteCodeGenerator::start_parameters() {
 	if (function->_default_arg_count > 0) {
-		append(RuztaFunction::OPCODE_JUMP_TO_DEF_ARGUMENT);
+		append_opcode(RuztaFunction::OPCODE_JUMP_TO_DEF_ARGUMENT);
 		function->default_arguments.push_back(opcodes.size());
 	}
 }
@@ -164,6 +191,7 @@ void RuztaByteCodeGenerator::write_start(Ruzta *p_script, const StringName &p_fu
 
 	function->name = p_function_name;
 	function->_script = p_script;
+	function->_line_opcodes = RuztaLanguage::get_singleton()->should_track_call_stack() && EngineDebugger::get_singleton()->is_active();
 	function->source = p_script->get_script_path();
 
 #ifdef DEBUG_ENABLED
@@ -177,6 +205,896 @@ void RuztaByteCodeGenerator::write_start(Ruzta *p_script, const StringName &p_fu
 	function->_argument_count = 0;
 }
 
+// Address operands an instruction reads and writes, as offsets from its opcode.
+struct OperandAccess {
+	int reads[2] = {};
+	int read_count = 0;
+	int write = 0; // None if 0.
+};
+
+// Only instructions that touch nothing but the listed operands are described. The optimizer assumes any other
+// instruction reads and writes every address it mentions, including in place through a base operand.
+static bool _get_operand_access(int p_opcode, OperandAccess &r_access) {
+	r_access = OperandAccess();
+	if (p_opcode >= RuztaFunction::OPCODE_OPERATOR && p_opcode <= RuztaFunction::OPCODE_JUMP_IF_NOT_GREATER_EQUAL_FLOAT) {
+		// Generic, validated, quickened and unboxed operators, and the compare+branch forms of them.
+		r_access.reads[0] = 1;
+		r_access.reads[1] = 2;
+		r_access.read_count = 2;
+		r_access.write = 3;
+		return true;
+	}
+
+	switch (p_opcode) {
+		case RuztaFunction::OPCODE_GET_KEYED:
+		case RuztaFunction::OPCODE_GET_KEYED_VALIDATED:
+		case RuztaFunction::OPCODE_GET_INDEXED_VALIDATED:
+		case RuztaFunction::OPCODE_GET_KEYED_QUICKENED:
+			r_access.reads[0] = 1;
+			r_access.reads[1] = 2;
+			r_access.read_count = 2;
+			r_access.write = 3;
+			return true;
+		case RuztaFunction::OPCODE_GET_NAMED:
+		case RuztaFunction::OPCODE_GET_NAMED_VALIDATED:
+		case RuztaFunction::OPCODE_GET_NAMED_QUICKENED:
+			r_access.reads[0] = 1;
+			r_access.read_count = 1;
+			r_access.write = 2;
+			return true;
+		case RuztaFunction::OPCODE_ASSIGN:
+		case RuztaFunction::OPCODE_ASSIGN_TYPED_BUILTIN:
+		case RuztaFunction::OPCODE_TYPE_TEST_BUILTIN:
+			r_access.reads[0] = 2;
+			r_access.read_count = 1;
+			r_access.write = 1;
+			return true;
+		case RuztaFunction::OPCODE_ASSIGN_NULL:
+		case RuztaFunction::OPCODE_ASSIGN_TRUE:
+		case RuztaFunction::OPCODE_ASSIGN_FALSE:
+		case RuztaFunction::OPCODE_GET_MEMBER:
+			r_access.write = 1;
+			return true;
+		case RuztaFunction::OPCODE_SET_MEMBER:
+		case RuztaFunction::OPCODE_JUMP_IF:
+		case RuztaFunction::OPCODE_JUMP_IF_NOT:
+		case RuztaFunction::OPCODE_RETURN:
+		case RuztaFunction::OPCODE_RETURN_TYPED_BUILTIN:
+			r_access.reads[0] = 1;
+			r_access.read_count = 1;
+			return true;
+		default:
+			return false;
+	}
+}
+
+// Operator and operand types of the unboxed operator opcodes.
+static bool _get_unboxed_operator(int p_opcode, Variant::Operator &r_op, Variant::Type &r_left, Variant::Type &r_right) {
+#define UNBOXED_OPERATOR(m_name, m_op, m_left, m_right) \
+	case RuztaFunction::OPCODE_OPERATOR_##m_name:       \
+		r_op = Variant::m_op;                           \
+		r_left = Variant::m_left;                       \
+		r_right = Variant::m_right;                     \
+		return true
+
+	switch (p_opcode) {
+		UNBOXED_OPERATOR(ADD_INT, OP_ADD, INT, INT);
+		UNBOXED_OPERATOR(SUB_INT, OP_SUBTRACT, INT, INT);
+		UNBOXED_OPERATOR(MUL_INT, OP_MULTIPLY, INT, INT);
+		UNBOXED_OPERATOR(EQUAL_INT, OP_EQUAL, INT, INT);
+		UNBOXED_OPERATOR(NOT_EQUAL_INT, OP_NOT_EQUAL, INT, INT);
+		UNBOXED_OPERATOR(LESS_INT, OP_LESS, INT, INT);
+		UNBOXED_OPERATOR(LESS_EQUAL_INT, OP_LESS_EQUAL, INT, INT);
+		UNBOXED_OPERATOR(GREATER_INT, OP_GREATER, INT, INT);
+		UNBOXED_OPERATOR(GREATER_EQUAL_INT, OP_GREATER_EQUAL, INT, INT);
+		UNBOXED_OPERATOR(ADD_FLOAT, OP_ADD, FLOAT, FLOAT);
+		UNBOXED_OPERATOR(SUB_FLOAT, OP_SUBTRACT, FLOAT, FLOAT);
+		UNBOXED_OPERATOR(MUL_FLOAT, OP_MULTIPLY, FLOAT, FLOAT);
+		UNBOXED_OPERATOR(DIV_FLOAT, OP_DIVIDE, FLOAT, FLOAT);
+		UNBOXED_OPERATOR(EQUAL_FLOAT, OP_EQUAL, FLOAT, FLOAT);
+		UNBOXED_OPERATOR(NOT_EQUAL_FLOAT, OP_NOT_EQUAL, FLOAT, FLOAT);
+		UNBOXED_OPERATOR(LESS_FLOAT, OP_LESS, FLOAT, FLOAT);
+		UNBOXED_OPERATOR(LESS_EQUAL_FLOAT, OP_LESS_EQUAL, FLOAT, FLOAT);
+		UNBOXED_OPERATOR(GREATER_FLOAT, OP_GREATER, FLOAT, FLOAT);
+		UNBOXED_OPERATOR(GREATER_EQUAL_FLOAT, OP_GREATER_EQUAL, FLOAT, FLOAT);
+		UNBOXED_OPERATOR(ADD_VECTOR2, OP_ADD, VECTOR2, VECTOR2);
+		UNBOXED_OPERATOR(SUB_VECTOR2, OP_SUBTRACT, VECTOR2, VECTOR2);
+		UNBOXED_OPERATOR(MUL_VECTOR2, OP_MULTIPLY, VECTOR2, VECTOR2);
+		UNBOXED_OPERATOR(MUL_VECTOR2_FLOAT, OP_MULTIPLY, VECTOR2, FLOAT);
+		UNBOXED_OPERATOR(ADD_VECTOR3, OP_ADD, VECTOR3, VECTOR3);
+		UNBOXED_OPERATOR(SUB_VECTOR3, OP_SUBTRACT, VECTOR3, VECTOR3);
+		UNBOXED_OPERATOR(MUL_VECTOR3, OP_MULTIPLY, VECTOR3, VECTOR3);
+		UNBOXED_OPERATOR(MUL_VECTOR3_FLOAT, OP_MULTIPLY, VECTOR3, FLOAT);
+		default:
+			return false;
+	}
+
+#undef UNBOXED_OPERATOR
+}
+
+// Updates the copies known to hold, from before the instruction at `p_start` to after it. `r_copies[slot]` is the
+// address that slot currently holds a copy of, or -1.
+static void _apply_copies(const int *p_code, int p_start, int p_end, const bool *p_is_jump_operand, int p_slot_count, int *r_copies) {
+#define IS_COPY_SLOT(m_address) ((m_address) >= RuztaFunction::FIXED_ADDRESSES_MAX && (m_address) < p_slot_count)
+#define FORGET_SLOT(m_slot)                                                           \
+	for (int s = RuztaFunction::FIXED_ADDRESSES_MAX; s < p_slot_count; s++) {         \
+		if (s == (m_slot) || r_copies[s] == (m_slot)) {                               \
+			r_copies[s] = -1;                                                         \
+		}                                                                             \
+	}
+
+	OperandAccess access;
+	if (!_get_operand_access(p_code[p_start], access)) {
+		for (int j = p_start + 1; j < p_end; j++) {
+			if (!p_is_jump_operand[j] && IS_COPY_SLOT(p_code[j])) {
+				FORGET_SLOT(p_code[j]);
+			}
+		}
+		return;
+	}
+	if (access.write == 0 || !IS_COPY_SLOT(p_code[p_start + access.write])) {
+		return;
+	}
+
+	const int written = p_code[p_start + access.write];
+	FORGET_SLOT(written);
+	if (p_code[p_start] == RuztaFunction::OPCODE_ASSIGN) {
+		const int source = p_code[p_start + 2];
+		const bool is_constant = ((source & RuztaFunction::ADDR_TYPE_MASK) >> RuztaFunction::ADDR_BITS) == RuztaFunction::ADDR_TYPE_CONSTANT;
+		if (source != written && (is_constant || IS_COPY_SLOT(source))) {
+			r_copies[written] = source;
+		}
+	}
+
+#undef FORGET_SLOT
+#undef IS_COPY_SLOT
+}
+
+// Cleans up the finished code: threads jumps through unconditional jumps, propagates copies, folds operators on
+// constants, drops jumps to the next instruction, clears of slots that are already null and dead stores to
+// temporaries, and removes code that cannot be reached. Temporaries left without code are dropped from the stack.
+// Instruction boundaries and jump operands are the ones recorded while appending, if they don't add up the code is
+// left as is.
+void RuztaByteCodeGenerator::optimize_code() {
+	const int code_size = opcodes.size();
+	const int instruction_count = instruction_starts.size();
+	if (instruction_count == 0 || instruction_starts[0] != 0) {
+		return;
+	}
+
+	// Instruction owning each code position, and where each instruction ends.
+	Vector<int> owner;
+	owner.resize(code_size);
+	int *owner_ptr = owner.ptrw();
+	Vector<int> ends;
+	ends.resize(instruction_count);
+	int *ends_ptr = ends.ptrw();
+	for (int i = 0; i < instruction_count; i++) {
+		const int start = instruction_starts[i];
+		const int end = i + 1 < instruction_count ? instruction_starts[i + 1] : code_size;
+		if (end <= start || end > code_size) {
+			return;
+		}
+		for (int j = start; j < end; j++) {
+			owner_ptr[j] = i;
+		}
+		ends_ptr[i] = end;
+	}
+
+	Vector<bool> is_jump_operand;
+	is_jump_operand.resize(code_size);
+	bool *is_jump_operand_ptr = is_jump_operand.ptrw();
+	for (int i = 0; i < code_size; i++) {
+		is_jump_operand_ptr[i] = false;
+	}
+
+#define IS_INSTRUCTION_START(m_pos) ((m_pos) >= 0 && (m_pos) < code_size && instruction_starts[owner_ptr[(m_pos)]] == (m_pos))
+
+	// Code this pass doesn't understand is kept unoptimized rather than reported, it's still valid code.
+	for (const int &pos : jump_operands) {
+		if (pos <= 0 || pos >= code_size || IS_INSTRUCTION_START(pos) || !IS_INSTRUCTION_START(opcodes[pos])) {
+			return;
+		}
+		is_jump_operand_ptr[pos] = true;
+	}
+	for (int i = 0; i < function->default_arguments.size(); i++) {
+		if (!IS_INSTRUCTION_START(function->default_arguments[i])) {
+			return;
+		}
+	}
+	for (int i = 0; i < instruction_count; i++) {
+		const int start = instruction_starts[i];
+		if (opcodes[start] == RuztaFunction::OPCODE_JUMP && (start + 1 >= code_size || !is_jump_operand_ptr[start + 1])) {
+			return;
+		}
+	}
+
+#undef IS_INSTRUCTION_START
+
+#ifdef DEBUG_ENABLED
+	const Vector<int> unoptimized = opcodes; // Copy before writing, for the disassembler diff.
+#endif
+	int *code = opcodes.ptrw();
+
+	const int temporary_base = RuztaFunction::FIXED_ADDRESSES_MAX + max_locals;
+	const int temporary_count = temporaries.size();
+	const int slot_count = temporary_base + temporary_count;
+
+	// Temporary whose address each code position holds, or -1. Kept up to date as operands are rewritten.
+	Vector<int> temporary_at;
+	temporary_at.resize(code_size);
+	int *temporary_at_ptr = temporary_at.ptrw();
+	for (int i = 0; i < code_size; i++) {
+		temporary_at_ptr[i] = -1;
+	}
+	for (int i = 0; i < temporary_count; i++) {
+		for (const int &pos : temporaries[i].bytecode_indices) {
+			temporary_at_ptr[pos] = i;
+		}
+	}
+
+#define FALLS_THROUGH(m_opcode) ((m_opcode) != RuztaFunction::OPCODE_JUMP && (m_opcode) != RuztaFunction::OPCODE_END && ((m_opcode) < RuztaFunction::OPCODE_RETURN || (m_opcode) > RuztaFunction::OPCODE_RETURN_TYPED_SCRIPT))
+
+	bool changed = false;
+
+	// Jump threading.
+	for (const int &pos : jump_operands) {
+		int target = code[pos];
+		for (int hops = 0; hops < instruction_count && code[target] == RuztaFunction::OPCODE_JUMP && code[target + 1] != target; hops++) {
+			target = code[target + 1];
+		}
+		if (target != code[pos]) {
+			code[pos] = target;
+			changed = true;
+		}
+	}
+
+	// Reachability, from the entry and every default argument entry.
+	Vector<bool> reachable;
+	reachable.resize(instruction_count);
+	bool *reachable_ptr = reachable.ptrw();
+	for (int i = 0; i < instruction_count; i++) {
+		reachable_ptr[i] = false;
+	}
+
+	Vector<int> pending;
+	pending.push_back(0);
+	for (int i = 0; i < function->default_arguments.size(); i++) {
+		pending.push_back(owner_ptr[function->default_arguments[i]]);
+	}
+	while (!pending.is_empty()) {
+		const int i = pending[pending.size() - 1];
+		pending.resize(pending.size() - 1);
+		if (reachable_ptr[i]) {
+			continue;
+		}
+		reachable_ptr[i] = true;
+
+		const int start = instruction_starts[i];
+		for (int j = start + 1; j < ends_ptr[i]; j++) {
+			if (is_jump_operand_ptr[j]) {
+				pending.push_back(owner_ptr[code[j]]);
+			}
+		}
+
+		if (FALLS_THROUGH(code[start]) && i + 1 < instruction_count) {
+			pending.push_back(i + 1);
+		}
+	}
+	reachable_ptr[instruction_count - 1] = true; // Always keep the final `OPCODE_END`.
+
+	// Copy propagation. A plain assignment makes its destination a copy of its source until either is written
+	// again, and reads of the copy are taken from the source instead. That often leaves the assignment dead.
+	// Copies are tracked per block and merged where blocks join, a copy only holds if it does on every path.
+	Vector<int> block_of; // Index of the block each leading instruction starts, or -1.
+	block_of.resize(instruction_count);
+	int *block_of_ptr = block_of.ptrw();
+	for (int i = 0; i < instruction_count; i++) {
+		block_of_ptr[i] = -1;
+	}
+	block_of_ptr[0] = 0;
+	for (int i = 0; i < function->default_arguments.size(); i++) {
+		block_of_ptr[owner_ptr[function->default_arguments[i]]] = 0;
+	}
+	for (int i = 0; i < instruction_count; i++) {
+		if (!reachable_ptr[i]) {
+			continue;
+		}
+		const int start = instruction_starts[i];
+		bool branches = !FALLS_THROUGH(code[start]) || code[start] == RuztaFunction::OPCODE_JUMP_TO_DEF_ARGUMENT;
+		for (int j = start + 1; j < ends_ptr[i]; j++) {
+			if (is_jump_operand_ptr[j]) {
+				block_of_ptr[owner_ptr[code[j]]] = 0;
+				branches = true;
+			}
+		}
+		if (branches && i + 1 < instruction_count) {
+			block_of_ptr[i + 1] = 0;
+		}
+	}
+	int block_count = 0;
+	for (int i = 0; i < instruction_count; i++) {
+		if (block_of_ptr[i] >= 0) {
+			block_of_ptr[i] = block_count++;
+		}
+	}
+
+	Vector<int> copies_in; // Copies holding when each block is entered.
+	copies_in.resize(block_count * slot_count);
+	int *copies_in_ptr = copies_in.ptrw();
+	Vector<bool> block_seen;
+	block_seen.resize(block_count);
+	bool *block_seen_ptr = block_seen.ptrw();
+	Vector<bool> block_queued;
+	block_queued.resize(block_count);
+	bool *block_queued_ptr = block_queued.ptrw();
+	for (int b = 0; b < block_count; b++) {
+		block_seen_ptr[b] = false;
+		block_queued_ptr[b] = false;
+	}
+	Vector<int> copies;
+	copies.resize(slot_count);
+	int *copies_ptr = copies.ptrw();
+
+	pending.push_back(0);
+	for (int i = 0; i < function->default_arguments.size(); i++) {
+		pending.push_back(owner_ptr[function->default_arguments[i]]);
+	}
+	for (const int &i : pending) {
+		const int b = block_of_ptr[i];
+		for (int s = 0; s < slot_count; s++) {
+			copies_in_ptr[b * slot_count + s] = -1; // Nothing is known on entry.
+		}
+		block_seen_ptr[b] = true;
+		block_queued_ptr[b] = true;
+	}
+
+#define MERGE_COPIES_INTO(m_instruction)                                                 \
+	{                                                                                    \
+		const int into = block_of_ptr[(m_instruction)];                                  \
+		int *in = &copies_in_ptr[into * slot_count];                                     \
+		bool narrowed = !block_seen_ptr[into];                                           \
+		for (int s = 0; s < slot_count; s++) {                                           \
+			if (!block_seen_ptr[into]) {                                                 \
+				in[s] = copies_ptr[s];                                                   \
+			} else if (in[s] != -1 && in[s] != copies_ptr[s]) {                          \
+				in[s] = -1;                                                              \
+				narrowed = true;                                                         \
+			}                                                                            \
+		}                                                                                \
+		block_seen_ptr[into] = true;                                                     \
+		if (narrowed && !block_queued_ptr[into]) {                                       \
+			block_queued_ptr[into] = true;                                               \
+			pending.push_back((m_instruction));                                          \
+		}                                                                                \
+	}
+
+	while (!pending.is_empty()) {
+		int i = pending[pending.size() - 1];
+		pending.resize(pending.size() - 1);
+		block_queued_ptr[block_of_ptr[i]] = false;
+		for (int s = 0; s < slot_count; s++) {
+			copies_ptr[s] = copies_in_ptr[block_of_ptr[i] * slot_count + s];
+		}
+
+		while (true) {
+			const int start = instruction_starts[i];
+			_apply_copies(code, start, ends_ptr[i], is_jump_operand_ptr, slot_count, copies_ptr);
+			for (int j = start + 1; j < ends_ptr[i]; j++) {
+				if (is_jump_operand_ptr[j]) {
+					MERGE_COPIES_INTO(owner_ptr[code[j]]);
+				}
+			}
+			if (code[start] == RuztaFunction::OPCODE_JUMP_TO_DEF_ARGUMENT) {
+				for (int k = 0; k < function->default_arguments.size(); k++) {
+					MERGE_COPIES_INTO(owner_ptr[function->default_arguments[k]]);
+				}
+			}
+			if (!FALLS_THROUGH(code[start]) || i + 1 >= instruction_count) {
+				break;
+			}
+			if (block_of_ptr[i + 1] >= 0) {
+				MERGE_COPIES_INTO(i + 1);
+				break;
+			}
+			i++;
+		}
+	}
+
+#undef MERGE_COPIES_INTO
+
+	for (int i = 0; i < instruction_count; i++) {
+		if (block_of_ptr[i] < 0 || !block_seen_ptr[block_of_ptr[i]]) {
+			continue;
+		}
+		for (int s = 0; s < slot_count; s++) {
+			copies_ptr[s] = copies_in_ptr[block_of_ptr[i] * slot_count + s];
+		}
+		for (int k = i; k < instruction_count && (k == i || block_of_ptr[k] < 0); k++) {
+			const int start = instruction_starts[k];
+			OperandAccess access;
+			if (_get_operand_access(code[start], access)) {
+				for (int r = 0; r < access.read_count; r++) {
+					const int pos = start + access.reads[r];
+					const int address = code[pos];
+					// Operators initialize their target before reading, it must not become one of the operands.
+					const bool aliases_target = access.write != 0 && copies_ptr[address] == code[start + access.write];
+					if (address >= RuztaFunction::FIXED_ADDRESSES_MAX && address < slot_count && copies_ptr[address] != -1 && !aliases_target) {
+						code[pos] = copies_ptr[address];
+						temporary_at_ptr[pos] = code[pos] >= temporary_base && code[pos] < slot_count ? code[pos] - temporary_base : -1;
+						changed = true;
+					}
+				}
+			}
+			_apply_copies(code, start, ends_ptr[k], is_jump_operand_ptr, slot_count, copies_ptr);
+		}
+	}
+
+	// Constant folding of operators whose operands both ended up constant. The result is assigned from a new
+	// constant instead, as long as it is a value that can be shared between calls.
+	Vector<Variant> constants;
+	constants.resize(constant_map.size());
+	for (const KeyValue<Variant, int> &K : constant_map) {
+		constants.write[K.value] = K.key;
+	}
+	for (int i = 0; i < instruction_count; i++) {
+		const int start = instruction_starts[i];
+		const int opcode = code[start];
+		if (!reachable_ptr[i]) {
+			continue;
+		}
+
+		Variant::Operator op = Variant::OP_MAX;
+		Variant::Type left_type = Variant::NIL;
+		Variant::Type right_type = Variant::NIL;
+		if (opcode == RuztaFunction::OPCODE_OPERATOR) {
+			op = (Variant::Operator)code[start + 4];
+			if (op >= Variant::OP_MAX || op == Variant::OP_DIVIDE || op == Variant::OP_MODULE) {
+				continue; // Division errors are only reported when the code runs.
+			}
+		} else if (!_get_unboxed_operator(opcode, op, left_type, right_type)) {
+			continue;
+		}
+
+		const int left = code[start + 1];
+		const int right = code[start + 2];
+		if (((left & RuztaFunction::ADDR_TYPE_MASK) >> RuztaFunction::ADDR_BITS) != RuztaFunction::ADDR_TYPE_CONSTANT || ((right & RuztaFunction::ADDR_TYPE_MASK) >> RuztaFunction::ADDR_BITS) != RuztaFunction::ADDR_TYPE_CONSTANT) {
+			continue;
+		}
+		const int left_index = left & RuztaFunction::ADDR_MASK;
+		const int right_index = right & RuztaFunction::ADDR_MASK;
+		if (left_index >= constants.size() || right_index >= constants.size()) {
+			continue;
+		}
+		const Variant &a = constants[left_index];
+		const Variant &b = constants[right_index];
+		if ((left_type != Variant::NIL && a.get_type() != left_type) || (right_type != Variant::NIL && b.get_type() != right_type)) {
+			continue;
+		}
+
+		Variant result;
+		bool valid = false;
+		RuztaVariantExtension::evaluate(op, a, b, result, valid);
+		if (!valid || !(_is_trivial_type(result.get_type()) || result.get_type() == Variant::STRING)) {
+			continue;
+		}
+
+		const int index = add_or_get_constant(result);
+		if (index >= constants.size()) {
+			constants.push_back(result);
+		}
+		const int target = start + 3;
+		code[start] = RuztaFunction::OPCODE_ASSIGN;
+		code[start + 1] = code[target];
+		code[start + 2] = index | (RuztaFunction::ADDR_TYPE_CONSTANT << RuztaFunction::ADDR_BITS);
+		temporary_at_ptr[start + 1] = temporary_at_ptr[target];
+		for (int j = start + 2; j < ends_ptr[i]; j++) {
+			temporary_at_ptr[j] = -1;
+		}
+		ends_ptr[i] = start + 3;
+		changed = true;
+	}
+
+	// Clearing a slot that is already null on every path is redundant. Temporaries start null, and a slot
+	// stays null until an instruction mentions it. Every operand that may be its address counts, so
+	// immediates only make this more conservative.
+	const int slot_words = (slot_count + 63) / 64;
+	Vector<uint64_t> null_slots; // Slots known to be null before each instruction.
+	null_slots.resize(instruction_count * slot_words);
+	uint64_t *null_slots_ptr = null_slots.ptrw();
+	for (int i = 0; i < instruction_count * slot_words; i++) {
+		null_slots_ptr[i] = ~uint64_t(0); // Nothing is known to be non-null until a path reaches it.
+	}
+
+	Vector<uint64_t> entry_null_slots;
+	entry_null_slots.resize(slot_words);
+	uint64_t *entry_null_slots_ptr = entry_null_slots.ptrw();
+	for (int w = 0; w < slot_words; w++) {
+		entry_null_slots_ptr[w] = 0;
+	}
+	for (int slot = temporary_base; slot < slot_count; slot++) {
+		entry_null_slots_ptr[slot / 64] |= uint64_t(1) << (slot % 64);
+	}
+
+	Vector<bool> queued;
+	queued.resize(instruction_count);
+	bool *queued_ptr = queued.ptrw();
+	Vector<bool> visited;
+	visited.resize(instruction_count);
+	bool *visited_ptr = visited.ptrw();
+	for (int i = 0; i < instruction_count; i++) {
+		queued_ptr[i] = false;
+		visited_ptr[i] = false;
+	}
+
+	pending.push_back(0);
+	for (int i = 0; i < function->default_arguments.size(); i++) {
+		pending.push_back(owner_ptr[function->default_arguments[i]]);
+	}
+	for (int i = 0; i < pending.size(); i++) {
+		uint64_t *in = &null_slots_ptr[pending[i] * slot_words];
+		for (int w = 0; w < slot_words; w++) {
+			in[w] &= entry_null_slots_ptr[w];
+		}
+		queued_ptr[pending[i]] = true;
+	}
+
+	Vector<uint64_t> null_out;
+	null_out.resize(slot_words);
+	uint64_t *null_out_ptr = null_out.ptrw();
+	while (!pending.is_empty()) {
+		const int i = pending[pending.size() - 1];
+		pending.resize(pending.size() - 1);
+		queued_ptr[i] = false;
+		visited_ptr[i] = true;
+
+		const int start = instruction_starts[i];
+		const int end = ends_ptr[i];
+		for (int w = 0; w < slot_words; w++) {
+			null_out_ptr[w] = null_slots_ptr[i * slot_words + w];
+		}
+		for (int j = start + 1; j < end; j++) {
+			if (!is_jump_operand_ptr[j] && code[j] >= 0 && code[j] < slot_count) {
+				null_out_ptr[code[j] / 64] &= ~(uint64_t(1) << (code[j] % 64));
+			}
+		}
+		const int opcode = code[start];
+		if (opcode == RuztaFunction::OPCODE_ASSIGN_NULL && code[start + 1] >= 0 && code[start + 1] < slot_count) {
+			null_out_ptr[code[start + 1] / 64] |= uint64_t(1) << (code[start + 1] % 64);
+		}
+
+		for (int j = start; j < end; j++) {
+			int successor;
+			if (j == start) {
+				if (!FALLS_THROUGH(opcode) || i + 1 >= instruction_count) {
+					continue;
+				}
+				successor = i + 1;
+			} else if (is_jump_operand_ptr[j]) {
+				successor = owner_ptr[code[j]];
+			} else {
+				continue;
+			}
+			uint64_t *in = &null_slots_ptr[successor * slot_words];
+			bool narrowed = false;
+			for (int w = 0; w < slot_words; w++) {
+				const uint64_t merged = in[w] & null_out_ptr[w];
+				narrowed = narrowed || merged != in[w];
+				in[w] = merged;
+			}
+			if ((narrowed || !visited_ptr[successor]) && !queued_ptr[successor]) {
+				queued_ptr[successor] = true;
+				pending.push_back(successor);
+			}
+		}
+	}
+
+	// Dead stores to temporaries. Every mention of a temporary counts as a read, except the destination of a plain
+	// assignment, which is the only write that kills it. Only assignments of trivial values to trivially typed
+	// temporaries are removed, so no reference is released at a different time.
+	if (temporary_count > 0) {
+		const int live_words = (temporary_count + 63) / 64;
+		Vector<uint64_t> live_in; // Temporaries read before being assigned again, from each instruction on.
+		live_in.resize(instruction_count * live_words);
+		uint64_t *live_in_ptr = live_in.ptrw();
+		for (int i = 0; i < instruction_count * live_words; i++) {
+			live_in_ptr[i] = 0;
+		}
+		Vector<uint64_t> live_out;
+		live_out.resize(instruction_count * live_words);
+		uint64_t *live_out_ptr = live_out.ptrw();
+		Vector<uint64_t> live_before; // Recomputed `live_in` of the instruction being visited.
+		live_before.resize(live_words);
+		uint64_t *live_before_ptr = live_before.ptrw();
+
+#define IS_TEMPORARY(m_address) ((m_address) >= temporary_base && (m_address) < slot_count)
+#define IS_TRIVIAL_TEMPORARY(m_address) (IS_TEMPORARY(m_address) && _is_trivial_type(temporaries[(m_address) - temporary_base].type))
+
+		bool grown = true;
+		while (grown) {
+			grown = false;
+			for (int i = instruction_count - 1; i >= 0; i--) {
+				if (!reachable_ptr[i]) {
+					continue;
+				}
+				const int start = instruction_starts[i];
+				const int end = ends_ptr[i];
+				const int opcode = code[start];
+				uint64_t *live = &live_out_ptr[i * live_words];
+				for (int w = 0; w < live_words; w++) {
+					live[w] = 0;
+				}
+
+				if (FALLS_THROUGH(opcode) && i + 1 < instruction_count) {
+					for (int w = 0; w < live_words; w++) {
+						live[w] |= live_in_ptr[(i + 1) * live_words + w];
+					}
+				}
+				for (int j = start + 1; j < end; j++) {
+					if (is_jump_operand_ptr[j]) {
+						for (int w = 0; w < live_words; w++) {
+							live[w] |= live_in_ptr[owner_ptr[code[j]] * live_words + w];
+						}
+					}
+				}
+				if (opcode == RuztaFunction::OPCODE_JUMP_TO_DEF_ARGUMENT) {
+					for (int k = 0; k < function->default_arguments.size(); k++) {
+						for (int w = 0; w < live_words; w++) {
+							live[w] |= live_in_ptr[owner_ptr[function->default_arguments[k]] * live_words + w];
+						}
+					}
+				}
+
+				uint64_t *in = &live_in_ptr[i * live_words];
+				for (int w = 0; w < live_words; w++) {
+					live_before_ptr[w] = live[w];
+				}
+				const bool assigns = opcode == RuztaFunction::OPCODE_ASSIGN || opcode == RuztaFunction::OPCODE_ASSIGN_TRUE || opcode == RuztaFunction::OPCODE_ASSIGN_FALSE;
+				if (assigns && IS_TEMPORARY(code[start + 1])) {
+					const int killed = code[start + 1] - temporary_base;
+					live_before_ptr[killed / 64] &= ~(uint64_t(1) << (killed % 64));
+				}
+				for (int j = start + (assigns ? 2 : 1); j < end; j++) {
+					if (!is_jump_operand_ptr[j] && IS_TEMPORARY(code[j])) {
+						const int read = code[j] - temporary_base;
+						live_before_ptr[read / 64] |= uint64_t(1) << (read % 64);
+					}
+				}
+				for (int w = 0; w < live_words; w++) {
+					if ((in[w] | live_before_ptr[w]) != in[w]) {
+						in[w] |= live_before_ptr[w];
+						grown = true;
+					}
+				}
+			}
+		}
+
+		for (int i = 0; i < instruction_count; i++) {
+			const int start = instruction_starts[i];
+			const int opcode = code[start];
+			const bool assigns = opcode == RuztaFunction::OPCODE_ASSIGN || opcode == RuztaFunction::OPCODE_ASSIGN_TRUE || opcode == RuztaFunction::OPCODE_ASSIGN_FALSE;
+			if (!reachable_ptr[i] || !assigns || !IS_TRIVIAL_TEMPORARY(code[start + 1])) {
+				continue;
+			}
+			bool trivial_store = true;
+			if (opcode == RuztaFunction::OPCODE_ASSIGN) {
+				const int source = code[start + 2];
+				trivial_store = ((source & RuztaFunction::ADDR_TYPE_MASK) >> RuztaFunction::ADDR_BITS) == RuztaFunction::ADDR_TYPE_CONSTANT || IS_TRIVIAL_TEMPORARY(source);
+			}
+			const int stored = code[start + 1] - temporary_base;
+			if (trivial_store && !(live_out_ptr[i * live_words + stored / 64] & (uint64_t(1) << (stored % 64)))) {
+				reachable_ptr[i] = false;
+			}
+		}
+
+#undef IS_TRIVIAL_TEMPORARY
+#undef IS_TEMPORARY
+	}
+
+	for (int i = 0; i < instruction_count; i++) {
+		const int start = instruction_starts[i];
+		if (reachable_ptr[i] && code[start] == RuztaFunction::OPCODE_ASSIGN_NULL && code[start + 1] >= 0 && code[start + 1] < slot_count) {
+			if (null_slots_ptr[i * slot_words + code[start + 1] / 64] & (uint64_t(1) << (code[start + 1] % 64))) {
+				reachable_ptr[i] = false;
+			}
+		}
+	}
+
+	// Jumps landing on the next kept instruction are no-ops.
+	int next_kept = instruction_count;
+	for (int i = instruction_count - 1; i >= 0; i--) {
+		if (!reachable_ptr[i]) {
+			continue;
+		}
+		const int start = instruction_starts[i];
+		if (code[start] == RuztaFunction::OPCODE_JUMP && next_kept < instruction_count && code[start + 1] == instruction_starts[next_kept]) {
+			reachable_ptr[i] = false;
+			continue;
+		}
+		next_kept = i;
+	}
+
+	// Temporaries only mentioned by removed code don't need a stack slot, renumber the rest.
+	Vector<int> temporary_remap;
+	temporary_remap.resize(temporary_count);
+	int *temporary_remap_ptr = temporary_remap.ptrw();
+	for (int i = 0; i < temporary_count; i++) {
+		temporary_remap_ptr[i] = -1;
+	}
+	for (int i = 0; i < instruction_count; i++) {
+		if (!reachable_ptr[i]) {
+			continue;
+		}
+		for (int j = instruction_starts[i] + 1; j < ends_ptr[i]; j++) {
+			if (temporary_at_ptr[j] >= 0) {
+				temporary_remap_ptr[temporary_at_ptr[j]] = 0;
+			}
+		}
+	}
+	Vector<StackSlot> kept_temporaries;
+	for (int i = 0; i < temporary_count; i++) {
+		if (temporary_remap_ptr[i] == 0) {
+			temporary_remap_ptr[i] = kept_temporaries.size();
+			kept_temporaries.push_back(temporaries[i]);
+		}
+	}
+	if (kept_temporaries.size() != temporary_count) {
+		changed = true;
+		for (int i = 0; i < instruction_count; i++) {
+			if (!reachable_ptr[i]) {
+				continue;
+			}
+			for (int j = instruction_starts[i] + 1; j < ends_ptr[i]; j++) {
+				if (temporary_at_ptr[j] >= 0) {
+					code[j] = (temporary_base + temporary_remap_ptr[temporary_at_ptr[j]]) | (RuztaFunction::ADDR_TYPE_STACK << RuztaFunction::ADDR_BITS);
+				}
+			}
+		}
+
+		Vector<RuztaFunction::TemporarySlot> temporary_slots;
+		for (const RuztaFunction::TemporarySlot &slot : function->temporary_slots) {
+			const int remapped = temporary_remap_ptr[slot.stack_index - temporary_base];
+			if (remapped >= 0) {
+				RuztaFunction::TemporarySlot kept = slot;
+				kept.stack_index = temporary_base + remapped;
+				temporary_slots.push_back(kept);
+			}
+		}
+		function->temporary_slots = temporary_slots;
+		function->_temporary_slots_ptr = function->temporary_slots.ptr();
+		function->_temporary_slots_count = function->temporary_slots.size();
+
+		Vector<int> nontrivial_slots;
+		for (const int &slot : function->nontrivial_slots) {
+			if (slot < temporary_base) {
+				nontrivial_slots.push_back(slot);
+			} else if (temporary_remap_ptr[slot - temporary_base] >= 0) {
+				nontrivial_slots.push_back(temporary_base + temporary_remap_ptr[slot - temporary_base]);
+			}
+		}
+		function->nontrivial_slots = nontrivial_slots;
+		function->_nontrivial_slots_ptr = function->nontrivial_slots.ptr();
+		function->_nontrivial_slots_count = function->nontrivial_slots.size();
+
+		temporaries = kept_temporaries; // The stack size is taken from these.
+	}
+
+#undef FALLS_THROUGH
+
+	// Compact the code and relocate every code address.
+	Vector<int> new_starts;
+	new_starts.resize(instruction_count);
+	int *new_starts_ptr = new_starts.ptrw();
+	int cursor = 0;
+	for (int i = 0; i < instruction_count; i++) {
+		new_starts_ptr[i] = cursor;
+		if (reachable_ptr[i]) {
+			for (int j = instruction_starts[i]; j < ends_ptr[i]; j++) {
+				code[cursor++] = code[j];
+			}
+		}
+	}
+
+	if (cursor != code_size) {
+		changed = true;
+		for (int i = 0; i < instruction_count; i++) {
+			if (!reachable_ptr[i]) {
+				continue;
+			}
+			const int start = instruction_starts[i];
+			for (int j = start + 1; j < ends_ptr[i]; j++) {
+				if (is_jump_operand_ptr[j]) {
+					const int relocated = new_starts_ptr[i] + (j - start);
+					code[relocated] = new_starts_ptr[owner_ptr[code[relocated]]];
+				}
+			}
+		}
+		for (int i = 0; i < function->default_arguments.size(); i++) {
+			function->default_arguments.write[i] = new_starts_ptr[owner_ptr[function->default_arguments[i]]];
+		}
+
+		// Lines of removed code collapse onto the next kept instruction, the last one wins.
+		Vector<RuztaFunction::LineEntry> lines;
+		for (const RuztaFunction::LineEntry &E : function->lines) {
+			if (E.ip >= code_size) {
+				continue;
+			}
+			RuztaFunction::LineEntry entry;
+			entry.ip = new_starts_ptr[owner_ptr[E.ip]];
+			entry.line = E.line;
+			if (!lines.is_empty() && lines[lines.size() - 1].ip == entry.ip) {
+				lines.write[lines.size() - 1].line = entry.line;
+			} else {
+				lines.push_back(entry);
+			}
+		}
+		function->lines = lines;
+
+		opcodes.resize(cursor);
+
+		Vector<int> kept_starts;
+		for (int i = 0; i < instruction_count; i++) {
+			if (reachable_ptr[i]) {
+				kept_starts.push_back(new_starts_ptr[i]);
+			}
+		}
+		instruction_starts = kept_starts;
+	}
+
+#ifdef DEBUG_ENABLED
+	if (changed) {
+		function->unoptimized_code = unoptimized;
+	}
+#else
+	(void)changed;
+#endif
+}
+
+// Superinstruction running an instruction together with the one right after it, or OPCODE_END if there's none.
+// These are the pairs the generator always emits back to back for a native property used as a call base and for
+// the container assignment starting a `for` loop.
+static RuztaFunction::Opcode _get_fused_opcode(int p_opcode, int p_next_opcode) {
+	switch (p_opcode) {
+		case RuztaFunction::OPCODE_GET_MEMBER:
+			switch (p_next_opcode) {
+				case RuztaFunction::OPCODE_CALL_METHOD_BIND_VALIDATED_RETURN:
+					return RuztaFunction::OPCODE_GET_MEMBER_CALL_VALIDATED_RETURN;
+				case RuztaFunction::OPCODE_CALL_METHOD_BIND_VALIDATED_NO_RETURN:
+					return RuztaFunction::OPCODE_GET_MEMBER_CALL_VALIDATED_NO_RETURN;
+				default:
+					return RuztaFunction::OPCODE_END;
+			}
+		case RuztaFunction::OPCODE_ASSIGN:
+			switch (p_next_opcode) {
+				case RuztaFunction::OPCODE_ITERATE_BEGIN:
+					return RuztaFunction::OPCODE_ASSIGN_ITERATE_BEGIN;
+				case RuztaFunction::OPCODE_ITERATE_BEGIN_ARRAY:
+					return RuztaFunction::OPCODE_ASSIGN_ITERATE_BEGIN_ARRAY;
+				default:
+					return RuztaFunction::OPCODE_END;
+			}
+		default:
+			return RuztaFunction::OPCODE_END;
+	}
+}
+
+// Runs after the optimizer, which doesn't know the fused forms. Only the opcode of the first instruction is rewritten,
+// its handler falls through to the second one, which stays in place for jumps landing on it.
+void RuztaByteCodeGenerator::fuse_instructions() {
+	int *code = opcodes.ptrw();
+	for (int i = 0; i + 1 < instruction_starts.size(); i++) {
+		const int start = instruction_starts[i];
+		const int next = instruction_starts[i + 1];
+		if (next != start + 3) {
+			continue; // Both first instructions take three positions.
+		}
+		const RuztaFunction::Opcode fused_opcode = _get_fused_opcode(code[start], code[next]);
+		if (fused_opcode != RuztaFunction::OPCODE_END) {
+			code[start] = fused_opcode;
+		}
+	}
+}
+
 RuztaFunction *RuztaByteCodeGenerator::write_end() {
 #ifdef DEBUG_ENABLED
 	if (!used_temporaries.is_empty()) {
@@ -191,9 +1109,33 @@ RuztaFunction *RuztaByteCodeGenerator::write_end() {
 			opcodes.write[temporaries[i].bytecode_indices[j]] = stack_index | (RuztaFunction::ADDR_TYPE_STACK << RuztaFunction::ADDR_BITS);
 		}
 		if (temporaries[i].type != Variant::NIL) {
-			function->temporary_slots[stack_index] = temporaries[i].type;
+			RuztaFunction::TemporarySlot slot;
+			slot.stack_index = stack_index;
+			slot.type = temporaries[i].type;
+			function->temporary_slots.push_back(slot);
+		}
+	}
+	function->_temporary_slots_ptr = function->temporary_slots.ptr();
+	function->_temporary_slots_count = function->temporary_slots.size();
+
+	// Only these are destroyed when the frame is torn down.
+	for (int i = RuztaFunction::FIXED_ADDRESSES_MAX; i < max_locals + RuztaFunction::FIXED_ADDRESSES_MAX; i++) {
+		if (nontrivial_locals.has(i)) {
+			function->nontrivial_slots.push_back(i);
 		}
 	}
+	for (int i = 0; i < temporaries.size(); i++) {
+		if (!_is_trivial_type(temporaries[i].type)) {
+			function->nontrivial_slots.push_back(i + max_locals + RuztaFunction::FIXED_ADDRESSES_MAX);
+		}
+	}
+	function->_nontrivial_slots_ptr = function->nontrivial_slots.ptr();
+	function->_nontrivial_slots_count = function->nontrivial_slots.size();
+
+	if (RuztaLanguage::get_singleton()->is_bytecode_optimizer_enabled()) {
+		optimize_code();
+	}
+	fuse_instructions();
 
 	if (constant_map.size()) {
 		function->_constant_count = constant_map.size();
@@ -221,8 +1163,12 @@ RuztaFunction *RuztaByteCodeGenerator::write_end() {
 	}
 
 	if (opcodes.size()) {
-		function->code = opcodes;
-		function->_code_ptr = &function->code.write[0];
+		if (RuztaLanguage::get_singleton()->is_compact_bytecode_enabled() && RuztaFunction::encode_compact_code(opcodes, function->compact_code)) {
+			function->_compact_code_ptr = function->compact_code.ptrw();
+		} else {
+			function->code = opcodes;
+			function->_code_ptr = &function->code.write[0];
+		}
 		function->_code_size = opcodes.size();
 
 	} else {
@@ -394,6 +1340,35 @@ RuztaFunction *RuztaByteCodeGenerator::write_end() {
 		function->_lambdas_count = 0;
 	}
 
+	if (call_cache_count) {
+		function->call_caches.resize(call_cache_count);
+		function->_call_caches_ptr = function->call_caches.ptrw();
+		function->_call_caches_count = call_cache_count;
+	} else {
+		function->_call_caches_ptr = nullptr;
+		function->_call_caches_count = 0;
+	}
+
+	function->direct_call_names = direct_call_names;
+
+	if (site_cache_count) {
+		function->site_caches.resize(site_cache_count);
+		function->_site_caches_ptr = function->site_caches.ptrw();
+		function->_site_caches_count = site_cache_count;
+	} else {
+		function->_site_caches_ptr = nullptr;
+		function->_site_caches_count = 0;
+	}
+
+	if (member_cache_count) {
+		function->member_caches.resize(member_cache_count);
+		function->_member_caches_ptr = function->member_caches.ptrw();
+		function->_member_caches_count = member_cache_count;
+	} else {
+		function->_member_caches_ptr = nullptr;
+		function->_member_caches_count = 0;
+	}
+
 	if (RuztaLanguage::get_singleton()->should_track_locals()) {
 		function->stack_debug = stack_debug;
 	}
@@ -575,12 +1550,89 @@ void RuztaByteCodeGenerator::write_unary_operator(const Address &p_target, Varia
 	append(Address());
 	append(p_target);
 	append(p_operator);
-	append(0); // Signature storage.
-	append(0); // Return type storage.
-	constexpr int _pointer_size = sizeof(RuztaVariantExtension::ValidatedOperatorEvaluator) / sizeof(*(opcodes.ptr()));
-	for (int i = 0; i < _pointer_size; i++) {
-		append(0); // Space for function pointer.
+	append(site_cache_count++); // Site cache index.
+}
+
+// Returns the dedicated opcode for an operation on statically typed scalars or small vectors, or OPCODE_END if there's none.
+static RuztaFunction::Opcode _get_unboxed_operator_opcode(Variant::Operator p_operator, Variant::Type p_left_type, Variant::Type p_right_type) {
+	if (p_left_type == Variant::INT && p_right_type == Variant::INT) {
+		switch (p_operator) {
+			case Variant::OP_ADD:
+				return RuztaFunction::OPCODE_OPERATOR_ADD_INT;
+			case Variant::OP_SUBTRACT:
+				return RuztaFunction::OPCODE_OPERATOR_SUB_INT;
+			case Variant::OP_MULTIPLY:
+				return RuztaFunction::OPCODE_OPERATOR_MUL_INT;
+			case Variant::OP_EQUAL:
+				return RuztaFunction::OPCODE_OPERATOR_EQUAL_INT;
+			case Variant::OP_NOT_EQUAL:
+				return RuztaFunction::OPCODE_OPERATOR_NOT_EQUAL_INT;
+			case Variant::OP_LESS:
+				return RuztaFunction::OPCODE_OPERATOR_LESS_INT;
+			case Variant::OP_LESS_EQUAL:
+				return RuztaFunction::OPCODE_OPERATOR_LESS_EQUAL_INT;
+			case Variant::OP_GREATER:
+				return RuztaFunction::OPCODE_OPERATOR_GREATER_INT;
+			case Variant::OP_GREATER_EQUAL:
+				return RuztaFunction::OPCODE_OPERATOR_GREATER_EQUAL_INT;
+			default:
+				break;
+		}
+	} else if (p_left_type == Variant::FLOAT && p_right_type == Variant::FLOAT) {
+		switch (p_operator) {
+			case Variant::OP_ADD:
+				return RuztaFunction::OPCODE_OPERATOR_ADD_FLOAT;
+			case Variant::OP_SUBTRACT:
+				return RuztaFunction::OPCODE_OPERATOR_SUB_FLOAT;
+			case Variant::OP_MULTIPLY:
+				return RuztaFunction::OPCODE_OPERATOR_MUL_FLOAT;
+			case Variant::OP_DIVIDE:
+				return RuztaFunction::OPCODE_OPERATOR_DIV_FLOAT;
+			case Variant::OP_EQUAL:
+				return RuztaFunction::OPCODE_OPERATOR_EQUAL_FLOAT;
+			case Variant::OP_NOT_EQUAL:
+				return RuztaFunction::OPCODE_OPERATOR_NOT_EQUAL_FLOAT;
+			case Variant::OP_LESS:
+				return RuztaFunction::OPCODE_OPERATOR_LESS_FLOAT;
+			case Variant::OP_LESS_EQUAL:
+				return RuztaFunction::OPCODE_OPERATOR_LESS_EQUAL_FLOAT;
+			case Variant::OP_GREATER:
+				return RuztaFunction::OPCODE_OPERATOR_GREATER_FLOAT;
+			case Variant::OP_GREATER_EQUAL:
+				return RuztaFunction::OPCODE_OPERATOR_GREATER_EQUAL_FLOAT;
+			default:
+				break;
+		}
+	} else if (p_left_type == Variant::VECTOR2 && p_right_type == Variant::VECTOR2) {
+		switch (p_operator) {
+			case Variant::OP_ADD:
+				return RuztaFunction::OPCODE_OPERATOR_ADD_VECTOR2;
+			case Variant::OP_SUBTRACT:
+				return RuztaFunction::OPCODE_OPERATOR_SUB_VECTOR2;
+			case Variant::OP_MULTIPLY:
+				return RuztaFunction::OPCODE_OPERATOR_MUL_VECTOR2;
+			default:
+				break;
+		}
+	} else if (p_left_type == Variant::VECTOR3 && p_right_type == Variant::VECTOR3) {
+		switch (p_operator) {
+			case Variant::OP_ADD:
+				return RuztaFunction::OPCODE_OPERATOR_ADD_VECTOR3;
+			case Variant::OP_SUBTRACT:
+				return RuztaFunction::OPCODE_OPERATOR_SUB_VECTOR3;
+			case Variant::OP_MULTIPLY:
+				return RuztaFunction::OPCODE_OPERATOR_MUL_VECTOR3;
+			default:
+				break;
+		}
+	} else if (p_operator == Variant::OP_MULTIPLY && p_right_type == Variant::FLOAT) {
+		if (p_left_type == Variant::VECTOR2) {
+			return RuztaFunction::OPCODE_OPERATOR_MUL_VECTOR2_FLOAT;
+		} else if (p_left_type == Variant::VECTOR3) {
+			return RuztaFunction::OPCODE_OPERATOR_MUL_VECTOR3_FLOAT;
+		}
 	}
+	return RuztaFunction::OPCODE_END;
 }
 
 void RuztaByteCodeGenerator::write_binary_operator(const Address &p_target, Variant::Operator p_operator, const Address &p_left_operand, const Address &p_right_operand) {
@@ -612,9 +1664,23 @@ void RuztaByteCodeGenerator::write_binary_operator(const Address &p_target, Vari
 			}
 		}
 
+		// Scalars and small vectors have opcodes that skip the evaluator call.
+		RuztaFunction::Opcode unboxed_opcode = _get_unboxed_operator_opcode(p_operator, p_left_operand.type.builtin_type, p_right_operand.type.builtin_type);
+		if (unboxed_opcode != RuztaFunction::OPCODE_END) {
+			last_operator_pos = opcodes.size();
+			last_operator_target = p_target;
+			append_opcode(unboxed_opcode);
+			append(p_left_operand);
+			append(p_right_operand);
+			append(p_target);
+			return;
+		}
+
 		// Gather specific operator.
 		RuztaVariantExtension::ValidatedOperatorEvaluator op_func = RuztaVariantExtension::get_validated_operator_evaluator(p_operator, p_left_operand.type.builtin_type, p_right_operand.type.builtin_type);
 
+		last_operator_pos = opcodes.size();
+		last_operator_target = p_target;
 		append_opcode(RuztaFunction::OPCODE_OPERATOR_VALIDATED);
 		append(p_left_operand);
 		append(p_right_operand);
@@ -632,12 +1698,57 @@ void RuztaByteCodeGenerator::write_binary_operator(const Address &p_target, Vari
 	append(p_right_operand);
 	append(p_target);
 	append(p_operator);
-	append(0); // Signature storage.
-	append(0); // Return type storage.
-	constexpr int _pointer_size = sizeof(RuztaVariantExtension::ValidatedOperatorEvaluator) / sizeof(*(opcodes.ptr()));
-	for (int i = 0; i < _pointer_size; i++) {
-		append(0); // Space for function pointer.
+	append(site_cache_count++); // Site cache index.
+}
+
+// Returns the superinstruction testing the result of a comparison, or OPCODE_END if there's none.
+static RuztaFunction::Opcode _get_jump_if_not_opcode(RuztaFunction::Opcode p_operator_opcode) {
+	switch (p_operator_opcode) {
+		case RuztaFunction::OPCODE_OPERATOR_VALIDATED:
+			return RuztaFunction::OPCODE_JUMP_IF_NOT_OPERATOR_VALIDATED;
+		case RuztaFunction::OPCODE_OPERATOR_EQUAL_INT:
+			return RuztaFunction::OPCODE_JUMP_IF_NOT_EQUAL_INT;
+		case RuztaFunction::OPCODE_OPERATOR_NOT_EQUAL_INT:
+			return RuztaFunction::OPCODE_JUMP_IF_NOT_NOT_EQUAL_INT;
+		case RuztaFunction::OPCODE_OPERATOR_LESS_INT:
+			return RuztaFunction::OPCODE_JUMP_IF_NOT_LESS_INT;
+		case RuztaFunction::OPCODE_OPERATOR_LESS_EQUAL_INT:
+			return RuztaFunction::OPCODE_JUMP_IF_NOT_LESS_EQUAL_INT;
+		case RuztaFunction::OPCODE_OPERATOR_GREATER_INT:
+			return RuztaFunction::OPCODE_JUMP_IF_NOT_GREATER_INT;
+		case RuztaFunction::OPCODE_OPERATOR_GREATER_EQUAL_INT:
+			return RuztaFunction::OPCODE_JUMP_IF_NOT_GREATER_EQUAL_INT;
+		case RuztaFunction::OPCODE_OPERATOR_EQUAL_FLOAT:
+			return RuztaFunction::OPCODE_JUMP_IF_NOT_EQUAL_FLOAT;
+		case RuztaFunction::OPCODE_OPERATOR_NOT_EQUAL_FLOAT:
+			return RuztaFunction::OPCODE_JUMP_IF_NOT_NOT_EQUAL_FLOAT;
+		case RuztaFunction::OPCODE_OPERATOR_LESS_FLOAT:
+			return RuztaFunction::OPCODE_JUMP_IF_NOT_LESS_FLOAT;
+		case RuztaFunction::OPCODE_OPERATOR_LESS_EQUAL_FLOAT:
+			return RuztaFunction::OPCODE_JUMP_IF_NOT_LESS_EQUAL_FLOAT;
+		case RuztaFunction::OPCODE_OPERATOR_GREATER_FLOAT:
+			return RuztaFunction::OPCODE_JUMP_IF_NOT_GREATER_FLOAT;
+		case RuztaFunction::OPCODE_OPERATOR_GREATER_EQUAL_FLOAT:
+			return RuztaFunction::OPCODE_JUMP_IF_NOT_GREATER_EQUAL_FLOAT;
+		default:
+			return RuztaFunction::OPCODE_END;
+	}
+}
+
+void RuztaByteCodeGenerator::append_jump_if_not(const Address &p_condition) {
+	// A comparison right before its own test takes the jump operand instead,
+	// unless something jumps in between the two.
+	if (last_operator_pos >= 0 && last_operator_pos == instruction_starts[instruction_starts.size() - 1] && last_jump_target != opcodes.size() && p_condition.mode == last_operator_target.mode && p_condition.address == last_operator_target.address) {
+		RuztaFunction::Opcode fused_opcode = _get_jump_if_not_opcode(RuztaFunction::Opcode(opcodes[last_operator_pos]));
+		if (fused_opcode != RuztaFunction::OPCODE_END) {
+			opcodes.write[last_operator_pos] = fused_opcode;
+			last_operator_pos = -1;
+			return;
+		}
 	}
+
+	append_opcode(RuztaFunction::OPCODE_JUMP_IF_NOT);
+	append(p_condition);
 }
 
 void RuztaByteCodeGenerator::write_type_test(const Address &p_target, const Address &p_source, const RuztaDataType &p_type) {
@@ -693,15 +1804,13 @@ void RuztaByteCodeGenerator::write_type_test(const Address &p_target, const Addr
 }
 
 void RuztaByteCodeGenerator::write_and_left_operand(const Address &p_left_operand) {
-	append_opcode(RuztaFunction::OPCODE_JUMP_IF_NOT);
-	append(p_left_operand);
+	append_jump_if_not(p_left_operand);
 	logic_op_jump_pos1.push_back(opcodes.size());
 	append(0); // Jump target, will be patched.
 }
 
 void RuztaByteCodeGenerator::write_and_right_operand(const Address &p_right_operand) {
-	append_opcode(RuztaFunction::OPCODE_JUMP_IF_NOT);
-	append(p_right_operand);
+	append_jump_if_not(p_right_operand);
 	logic_op_jump_pos2.push_back(opcodes.size());
 	append(0); // Jump target, will be patched.
 }
@@ -712,7 +1821,7 @@ void RuztaByteCodeGenerator::write_end_and(const Address &p_target) {
 	append(p_target);
 	// Jump away from the fail condition.
 	append_opcode(RuztaFunction::OPCODE_JUMP);
-	append(opcodes.size() + 3);
+	append_jump_target(opcodes.size() + 3);
 	// Here it means one of operands is false.
 	patch_jump(logic_op_jump_pos1.back()->get());
 	patch_jump(logic_op_jump_pos2.back()->get());
@@ -742,7 +1851,7 @@ void RuztaByteCodeGenerator::write_end_or(const Address &p_target) {
 	append(p_target);
 	// Jump away from the success condition.
 	append_opcode(RuztaFunction::OPCODE_JUMP);
-	append(opcodes.size() + 3);
+	append_jump_target(opcodes.size() + 3);
 	// Here it means one of operands is true.
 	patch_jump(logic_op_jump_pos1.back()->get());
 	patch_jump(logic_op_jump_pos2.back()->get());
@@ -757,8 +1866,7 @@ void RuztaByteCodeGenerator::write_start_ternary(const Address &p_target) {
 }
 
 void RuztaByteCodeGenerator::write_ternary_condition(const Address &p_condition) {
-	append_opcode(RuztaFunction::OPCODE_JUMP_IF_NOT);
-	append(p_condition);
+	append_jump_if_not(p_condition);
 	ternary_jump_fail_pos.push_back(opcodes.size());
 	append(0); // Jump target, will be patched.
 }
@@ -815,6 +1923,7 @@ void RuztaByteCodeGenerator::write_set(const Address &p_target, const Address &p
 	append(p_target);
 	append(p_index);
 	append(p_source);
+	append(site_cache_count++); // Site cache index.
 }
 
 void RuztaByteCodeGenerator::write_get(const Address &p_target, const Address &p_index, const Address &p_source) {
@@ -842,6 +1951,7 @@ void RuztaByteCodeGenerator::write_get(const Address &p_target, const Address &p
 	append(p_source);
 	append(p_index);
 	append(p_target);
+	append(site_cache_count++); // Site cache index.
 }
 
 void RuztaByteCodeGenerator::write_set_named(const Address &p_target, const StringName &p_name, const Address &p_source) {
@@ -861,6 +1971,8 @@ void RuztaByteCodeGenerator::write_set_named(const Address &p_target, const Stri
 	append(p_target);
 	append(p_source);
 	append(p_name);
+	append(site_cache_count++); // Site cache index.
+	append(member_cache_count++); // Member cache index.
 }
 
 void RuztaByteCodeGenerator::write_get_named(const Address &p_target, const StringName &p_name, const Address &p_source) {
@@ -879,6 +1991,8 @@ void RuztaByteCodeGenerator::write_get_named(const Address &p_target, const Stri
 	append(p_source);
 	append(p_target);
 	append(p_name);
+	append(site_cache_count++); // Site cache index.
+	append(member_cache_count++); // Member cache index.
 }
 
 void RuztaByteCodeGenerator::write_set_member(const Address &p_value, const StringName &p_name) {
@@ -1023,6 +2137,7 @@ void RuztaByteCodeGenerator::write_assign_default_parameter(const Address &p_dst
 		write_assign(p_dst, p_src);
 	}
 	function->default_arguments.push_back(opcodes.size());
+	last_jump_target = opcodes.size();
 }
 
 void RuztaByteCodeGenerator::write_store_global(const Address &p_dst, int p_global_index) {
@@ -1092,6 +2207,7 @@ void RuztaByteCodeGenerator::write_call(const Address &p_target, const Address &
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append(call_cache_count++); // Call cache index.
 	ct.cleanup();
 }
 
@@ -1117,6 +2233,7 @@ void RuztaByteCodeGenerator::write_call_async(const Address &p_target, const Add
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append(call_cache_count++); // Call cache index.
 	ct.cleanup();
 }
 
@@ -1353,6 +2470,7 @@ void RuztaByteCodeGenerator::write_call_self(const Address &p_target, const Stri
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append(call_cache_count++); // Call cache index.
 	ct.cleanup();
 }
 
@@ -1366,6 +2484,20 @@ void RuztaByteCodeGenerator::write_call_self_async(const Address &p_target, cons
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append(call_cache_count++); // Call cache index.
+	ct.cleanup();
+}
+
+void RuztaByteCodeGenerator::write_call_direct(const Address &p_target, const StringName &p_function_name, const Vector<Address> &p_arguments, bool p_validated_args) {
+	append_opcode_and_argcount(p_validated_args ? RuztaFunction::OPCODE_CALL_DIRECT_VALIDATED : RuztaFunction::OPCODE_CALL_DIRECT, 1 + p_arguments.size());
+	for (int i = 0; i < p_arguments.size(); i++) {
+		append(p_arguments[i]);
+	}
+	CallTarget ct = get_call_target(p_target);
+	append(ct.target);
+	append(p_arguments.size());
+	append(direct_call_names.size()); // Direct call index.
+	direct_call_names.push_back(p_function_name);
 	ct.cleanup();
 }
 
@@ -1379,6 +2511,7 @@ void RuztaByteCodeGenerator::write_call_script_function(const Address &p_target,
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append(call_cache_count++); // Call cache index.
 	ct.cleanup();
 }
 
@@ -1506,15 +2639,32 @@ void RuztaByteCodeGenerator::write_construct_typed_dictionary(const Address &p_t
 }
 
 void RuztaByteCodeGenerator::write_await(const Address &p_target, const Address &p_operand) {
+	function->_coroutine = true;
 	append_opcode(RuztaFunction::OPCODE_AWAIT);
 	append(p_operand);
 	append_opcode(RuztaFunction::OPCODE_AWAIT_RESUME);
 	append(p_target);
 }
 
+void RuztaByteCodeGenerator::write_generator_start() {
+	// Generator frames are handed to their state, like the ones of coroutines.
+	function->_coroutine = true;
+	function->_generator = true;
+	// Suspends the first call before running anything, the value is ignored.
+	append_opcode(RuztaFunction::OPCODE_YIELD);
+	append(Address());
+}
+
+void RuztaByteCodeGenerator::write_yield(const Address &p_target, const Address &p_value) {
+	append_opcode(RuztaFunction::OPCODE_YIELD);
+	append(p_value);
+	// Receives the argument the generator is resumed with.
+	append_opcode(RuztaFunction::OPCODE_AWAIT_RESUME);
+	append(p_target);
+}
+
 void RuztaByteCodeGenerator::write_if(const Address &p_condition) {
-	append_opcode(RuztaFunction::OPCODE_JUMP_IF_NOT);
-	append(p_condition);
+	append_jump_if_not(p_condition);
 	if_jmp_addrs.push_back(opcodes.size());
 	append(0); // Jump destination, will be patched.
 }
@@ -1727,7 +2877,7 @@ void RuztaByteCodeGenerator::write_for(const Address &p_variable, bool p_use_con
 	for_jmp_addrs.push_back(opcodes.size());
 	append(0); // End of loop address, will be patched.
 	append_opcode(RuztaFunction::OPCODE_JUMP);
-	append(opcodes.size() + (p_is_range ? 7 : 6)); // Skip over 'continue' code.
+	append_jump_target(opcodes.size() + (p_is_range ? 7 : 6)); // Skip over 'continue' code.
 
 	// Next iteration.
 	int continue_addr = opcodes.size();
@@ -1755,7 +2905,7 @@ void RuztaByteCodeGenerator::write_for(const Address &p_variable, bool p_use_con
 void RuztaByteCodeGenerator::write_endfor(bool p_is_range) {
 	// Jump back to loop check.
 	append_opcode(RuztaFunction::OPCODE_JUMP);
-	append(continue_addrs.back()->get());
+	append_jump_target(continue_addrs.back()->get());
 	continue_addrs.pop_back();
 
 	// Patch end jumps (two of them).
@@ -1784,12 +2934,12 @@ void RuztaByteCodeGenerator::write_endfor(bool p_is_range) {
 void RuztaByteCodeGenerator::start_while_condition() {
 	current_breaks_to_patch.push_back(List<int>());
 	continue_addrs.push_back(opcodes.size());
+	last_jump_target = opcodes.size();
 }
 
 void RuztaByteCodeGenerator::write_while(const Address &p_condition) {
 	// Condition check.
-	append_opcode(RuztaFunction::OPCODE_JUMP_IF_NOT);
-	append(p_condition);
+	append_jump_if_not(p_condition);
 	while_jmp_addrs.push_back(opcodes.size());
 	append(0); // End of loop address, will be patched.
 }
@@ -1797,7 +2947,7 @@ void RuztaByteCodeGenerator::write_while(const Address &p_condition) {
 void RuztaByteCodeGenerator::write_endwhile() {
 	// Jump back to loop check.
 	append_opcode(RuztaFunction::OPCODE_JUMP);
-	append(continue_addrs.back()->get());
+	append_jump_target(continue_addrs.back()->get());
 	continue_addrs.pop_back();
 
 	// Patch end jump.
@@ -1819,7 +2969,7 @@ void RuztaByteCodeGenerator::write_break() {
 
 void RuztaByteCodeGenerator::write_continue() {
 	append_opcode(RuztaFunction::OPCODE_JUMP);
-	append(continue_addrs.back()->get());
+	append_jump_target(continue_addrs.back()->get());
 }
 
 void RuztaByteCodeGenerator::write_breakpoint() {
@@ -1827,11 +2977,22 @@ void RuztaByteCodeGenerator::write_breakpoint() {
 }
 
 void RuztaByteCodeGenerator::write_newline(int p_line) {
-	if (RuztaLanguage::get_singleton()->should_track_call_stack()) {
-		// Add newline for debugger and stack tracking if enabled in the project settings.
+	// Errors and backtraces look the line up from the code position, so running code doesn't track it.
+	const int ip = opcodes.size();
+	if (!function->lines.is_empty() && function->lines[function->lines.size() - 1].ip == ip) {
+		function->lines.write[function->lines.size() - 1].line = p_line;
+	} else {
+		RuztaFunction::LineEntry entry;
+		entry.ip = ip;
+		entry.line = p_line;
+		function->lines.push_back(entry);
+	}
+	current_line = p_line;
+
+	// Breakpoints and stepping still need an instruction, only emit it for code compiled under the debugger.
+	if (function->_line_opcodes) {
 		append_opcode(RuztaFunction::OPCODE_LINE);
 		append(p_line);
-		current_line = p_line;
 	}
 }
 
@@ -91,6 +91,8 @@ class RuztaByteCodeGenerator : public RuztaCodeGenerator {
 	RuztaFunction *function = nullptr;
 
 	Vector<int> opcodes;
+	Vector<int> instruction_starts; // Position of every opcode, for the optimizer and the superinstructions.
+	Vector<int> jump_operands; // Positions holding a code address, for the optimizer.
 	List<RBMap<StringName, int>> stack_id_stack;
 	RBMap<StringName, int> stack_identifiers;
 	List<int> stack_identifiers_counts;
@@ -98,6 +100,7 @@ class RuztaByteCodeGenerator : public RuztaCodeGenerator {
 
 	Vector<StackSlot> locals;
 	HashSet<int> dirty_locals;
+	HashSet<int> nontrivial_locals; // Stack positions some local of a type needing destruction used.
 
 	Vector<StackSlot> temporaries;
 	List<int> used_temporaries;
@@ -111,6 +114,13 @@ class RuztaByteCodeGenerator : public RuztaCodeGenerator {
 	int max_locals = 0;
 	int current_line = 0;
 	int instr_args_max = 0;
+	int site_cache_count = 0;
+	int member_cache_count = 0;
+	int call_cache_count = 0;
+	Vector<StringName> direct_call_names;
+	int last_operator_pos = -1; // Start of the last comparison, if it can still take the jump on its result.
+	Address last_operator_target;
+	int last_jump_target = -1;
 
 #ifdef DEBUG_ENABLED
 	List<int> temp_stack;
@@ -390,10 +400,12 @@ class RuztaByteCodeGenerator : public RuztaCodeGenerator {
 	}
 
 	void append_opcode(RuztaFunction::Opcode p_code) {
+		instruction_starts.push_back(opcodes.size());
 		opcodes.push_back(p_code);
 	}
 
 	void append_opcode_and_argcount(RuztaFunction::Opcode p_code, int p_argument_count) {
+		instruction_starts.push_back(opcodes.size());
 		opcodes.push_back(p_code);
 		opcodes.push_back(p_argument_count);
 		instr_args_max = MAX(instr_args_max, p_argument_count);
@@ -463,10 +475,22 @@ class RuztaByteCodeGenerator : public RuztaCodeGenerator {
 		opcodes.push_back(get_lambda_function_pos(p_lambda_function));
 	}
 
+	void append_jump_target(int p_target) {
+		jump_operands.push_back(opcodes.size());
+		last_jump_target = p_target;
+		opcodes.push_back(p_target);
+	}
+
 	void patch_jump(int p_address) {
+		jump_operands.push_back(p_address);
+		last_jump_target = opcodes.size();
 		opcodes.write[p_address] = opcodes.size();
 	}
 
+	void append_jump_if_not(const Address &p_condition);
+	void optimize_code();
+	void fuse_instructions();
+
 public:
 	virtual uint32_t add_parameter(const StringName &p_name, bool p_is_optional, const RuztaDataType &p_type) override;
 	virtual uint32_t add_local(const StringName &p_name, const RuztaDataType &p_type) override;
@@ -539,6 +563,7 @@ public:
 	virtual void write_call_method_bind_validated(const Address &p_target, const Address &p_base, MethodBind *p_method, const Vector<Address> &p_arguments) override;
 	virtual void write_call_self(const Address &p_target, const StringName &p_function_name, const Vector<Address> &p_arguments) override;
 	virtual void write_call_self_async(const Address &p_target, const StringName &p_function_name, const Vector<Address> &p_arguments) override;
+	virtual void write_call_direct(const Address &p_target, const StringName &p_function_name, const Vector<Address> &p_arguments, bool p_validated_args) override;
 	virtual void write_call_script_function(const Address &p_target, const Address &p_base, const StringName &p_function_name, const Vector<Address> &p_arguments) override;
 	virtual void write_lambda(const Address &p_target, RuztaFunction *p_function, const Vector<Address> &p_captures, bool p_use_self) override;
 	virtual void write_construct(const Address &p_target, Variant::Type p_type, const Vector<Address> &p_arguments) override;
@@ -547,6 +572,8 @@ public:
 	virtual void write_construct_dictionary(const Address &p_target, const Vector<Address> &p_arguments) override;
 	virtual void write_construct_typed_dictionary(const Address &p_target, const RuztaDataType &p_key_type, const RuztaDataType &p_value_type, const Vector<Address> &p_arguments) override;
 	virtual void write_await(const Address &p_target, const Address &p_operand) override;
+	virtual void write_generator_start() override;
+	virtual void write_yield(const Address &p_target, const Address &p_value) override;
 	virtual void write_if(const Address &p_condition) override;
 	virtual void write_else() override;
 	virtual void write_endif() override;
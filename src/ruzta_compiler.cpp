@@ -285,6 +285,250 @@ static bool _can_use_validate_call(const MethodBind *p_method, const Vector<Ruzt
 	return true;
 }
 
+// Functions returning a single expression with at most this many nodes are inlined without `@inline`.
+static constexpr int INLINE_MAX_NODES = 16;
+
+static bool _is_inlinable_expression(const RuztaParser::ExpressionNode *p_expression, int &r_budget) {
+	if (p_expression == nullptr) {
+		return true;
+	}
+	if (--r_budget < 0) {
+		return false;
+	}
+	if (p_expression->is_constant) {
+		return true;
+	}
+
+	switch (p_expression->type) {
+		case RuztaParser::Node::IDENTIFIER: {
+			// The body is a single `return`, so only parameters and class members can be referenced.
+			switch (static_cast<const RuztaParser::IdentifierNode *>(p_expression)->source) {
+				case RuztaParser::IdentifierNode::LOCAL_VARIABLE:
+				case RuztaParser::IdentifierNode::LOCAL_CONSTANT:
+				case RuztaParser::IdentifierNode::LOCAL_ITERATOR:
+				case RuztaParser::IdentifierNode::LOCAL_BIND:
+					return false;
+				default:
+					return true;
+			}
+		}
+		case RuztaParser::Node::SELF:
+			return true;
+		case RuztaParser::Node::UNARY_OPERATOR:
+			return _is_inlinable_expression(static_cast<const RuztaParser::UnaryOpNode *>(p_expression)->operand, r_budget);
+		case RuztaParser::Node::BINARY_OPERATOR: {
+			const RuztaParser::BinaryOpNode *binary = static_cast<const RuztaParser::BinaryOpNode *>(p_expression);
+			return _is_inlinable_expression(binary->left_operand, r_budget) && _is_inlinable_expression(binary->right_operand, r_budget);
+		}
+		case RuztaParser::Node::TERNARY_OPERATOR: {
+			const RuztaParser::TernaryOpNode *ternary = static_cast<const RuztaParser::TernaryOpNode *>(p_expression);
+			return _is_inlinable_expression(ternary->condition, r_budget) && _is_inlinable_expression(ternary->true_expr, r_budget) && _is_inlinable_expression(ternary->false_expr, r_budget);
+		}
+		case RuztaParser::Node::SUBSCRIPT: {
+			const RuztaParser::SubscriptNode *subscript = static_cast<const RuztaParser::SubscriptNode *>(p_expression);
+			return _is_inlinable_expression(subscript->base, r_budget) && (subscript->is_attribute || _is_inlinable_expression(subscript->index, r_budget));
+		}
+		case RuztaParser::Node::CALL: {
+			const RuztaParser::CallNode *call = static_cast<const RuztaParser::CallNode *>(p_expression);
+			if (call->is_super) {
+				return false;
+			}
+			if (call->callee != nullptr && call->callee->type == RuztaParser::Node::SUBSCRIPT) {
+				const RuztaParser::ExpressionNode *base = static_cast<const RuztaParser::SubscriptNode *>(call->callee)->base;
+				if (base->type == RuztaParser::Node::IDENTIFIER && static_cast<const RuztaParser::IdentifierNode *>(base)->source == RuztaParser::IdentifierNode::FUNCTION_PARAMETER) {
+					// Constant arguments are bound without copying, so methods that may modify a value type can't be called on them.
+					const RuztaParser::DataType &base_type = base->get_datatype();
+					bool is_shared = base_type.kind == RuztaParser::DataType::NATIVE || base_type.kind == RuztaParser::DataType::SCRIPT || base_type.kind == RuztaParser::DataType::CLASS;
+					is_shared = is_shared || (base_type.kind == RuztaParser::DataType::BUILTIN && RuztaVariantExtension::is_type_shared(base_type.builtin_type));
+					if (!base_type.is_hard_type() || !is_shared) {
+						return false;
+					}
+				}
+				if (!_is_inlinable_expression(base, r_budget)) {
+					return false;
+				}
+			}
+			for (const RuztaParser::ExpressionNode *argument : call->arguments) {
+				if (!_is_inlinable_expression(argument, r_budget)) {
+					return false;
+				}
+			}
+			return true;
+		}
+		case RuztaParser::Node::ARRAY: {
+			for (const RuztaParser::ExpressionNode *element : static_cast<const RuztaParser::ArrayNode *>(p_expression)->elements) {
+				if (!_is_inlinable_expression(element, r_budget)) {
+					return false;
+				}
+			}
+			return true;
+		}
+		case RuztaParser::Node::DICTIONARY: {
+			for (const RuztaParser::DictionaryNode::Pair &element : static_cast<const RuztaParser::DictionaryNode *>(p_expression)->elements) {
+				if (!_is_inlinable_expression(element.key, r_budget) || !_is_inlinable_expression(element.value, r_budget)) {
+					return false;
+				}
+			}
+			return true;
+		}
+		case RuztaParser::Node::CAST:
+			return _is_inlinable_expression(static_cast<const RuztaParser::CastNode *>(p_expression)->operand, r_budget);
+		case RuztaParser::Node::TYPE_TEST:
+			return _is_inlinable_expression(static_cast<const RuztaParser::TypeTestNode *>(p_expression)->operand, r_budget);
+		default:
+			// Lambdas, awaits, node paths and the like depend on the function they're compiled in.
+			return false;
+	}
+}
+
+const RuztaParser::FunctionNode *RuztaCompiler::_get_inline_function(const CodeGen &codegen, const RuztaParser::CallNode *p_call) const {
+	if (p_call->is_super || p_call->callee == nullptr || p_call->callee->type != RuztaParser::Node::IDENTIFIER || codegen.class_node == nullptr) {
+		return nullptr;
+	}
+	if (!codegen.class_node->has_member(p_call->function_name) || ClassDB::class_has_method(codegen.script->native->get_name(), p_call->function_name)) {
+		return nullptr;
+	}
+	const RuztaParser::ClassNode::Member &member = codegen.class_node->get_member(p_call->function_name);
+	if (member.type != RuztaParser::ClassNode::Member::FUNCTION) {
+		return nullptr;
+	}
+
+	const RuztaParser::FunctionNode *function = member.function;
+	// Static functions are always resolved in the class they're called from. Methods can be overridden unless marked as `@inline` or `@final`.
+	if (!function->is_static && !function->is_inline && !function->is_final && !codegen.class_node->is_final) {
+		return nullptr;
+	}
+	if (function == codegen.function_node || codegen.inlined_functions.has(function)) {
+		return nullptr;
+	}
+	// An inlined body has no frame of its own, so it couldn't be stepped into or break on its lines.
+	if (EngineDebugger::get_singleton()->is_active()) {
+		return nullptr;
+	}
+	if (function->is_coroutine || function->is_generator || function->is_abstract || function->is_vararg() || function->parameters.size() != p_call->arguments.size()) {
+		return nullptr;
+	}
+	if (function->body == nullptr || function->body->statements.size() != 1 || function->body->statements[0]->type != RuztaParser::Node::RETURN) {
+		return nullptr;
+	}
+	const RuztaParser::ReturnNode *return_n = static_cast<const RuztaParser::ReturnNode *>(function->body->statements[0]);
+	if (return_n->return_value == nullptr || return_n->void_return) {
+		return nullptr;
+	}
+
+	int budget = function->is_inline ? INT_MAX : INLINE_MAX_NODES;
+	if (!_is_inlinable_expression(return_n->return_value, budget)) {
+		return nullptr;
+	}
+	return function;
+}
+
+// Returns the function of the current class a call always ends up in, so it doesn't have to be looked up by name.
+const RuztaParser::FunctionNode *RuztaCompiler::_get_direct_call_function(const CodeGen &codegen, const RuztaParser::CallNode *p_call) const {
+	if (p_call->is_super || p_call->callee == nullptr || p_call->callee->type != RuztaParser::Node::IDENTIFIER || codegen.class_node == nullptr) {
+		return nullptr;
+	}
+	// `_ready()` also runs the implicit ready, see `RuztaInstance::callp()`.
+	if (!codegen.class_node->has_member(p_call->function_name) || p_call->function_name == RuztaLanguage::get_singleton()->strings._ready) {
+		return nullptr;
+	}
+	const RuztaParser::ClassNode::Member &member = codegen.class_node->get_member(p_call->function_name);
+	if (member.type != RuztaParser::ClassNode::Member::FUNCTION) {
+		return nullptr;
+	}
+
+	const RuztaParser::FunctionNode *function = member.function;
+	if (!function->is_static && !function->is_final && !function->is_inline && !codegen.class_node->is_final) {
+		return nullptr;
+	}
+	// Coroutines have to be awaited, and abstract functions are only implemented in derived classes.
+	if (function->is_coroutine || function->is_abstract) {
+		return nullptr;
+	}
+	return function;
+}
+
+// Whether the arguments of a direct call already have the exact types of the parameters, so the callee doesn't have to check them.
+bool RuztaCompiler::_are_direct_call_arguments_validated(const CodeGen &codegen, const RuztaParser::FunctionNode *p_function, const Vector<RuztaCodeGenerator::Address> &p_arguments) {
+	for (int i = 0; i < p_arguments.size() && i < p_function->parameters.size(); i++) {
+		RuztaDataType par_type = _gdtype_from_datatype(p_function->parameters[i]->get_datatype(), codegen.script);
+		if (!par_type.has_type()) {
+			continue;
+		}
+		// Objects may have been freed and containers may hold other element types, only plain built-in types are exact.
+		if (par_type.kind != RuztaDataType::BUILTIN || par_type.has_container_element_types() || !(p_arguments[i].type == par_type)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void RuztaCompiler::_parse_inline_call(CodeGen &codegen, Error &r_error, const RuztaParser::FunctionNode *p_function, const RuztaCodeGenerator::Address &p_result, const Vector<RuztaCodeGenerator::Address> &p_arguments) {
+	RuztaCodeGenerator *gen = codegen.generator;
+
+	// Bind the already evaluated arguments to the parameter names, converting them like the call would.
+	// Arguments read from members, locals or parameters of the caller are copied first: the body may
+	// call something writing to them, and a real call would still see the value passed in.
+	HashMap<StringName, RuztaCodeGenerator::Address> parameters;
+	int bound_temporaries = 0;
+	for (int i = 0; i < p_function->parameters.size(); i++) {
+		RuztaCodeGenerator::Address argument = p_arguments[i];
+		RuztaDataType par_type = _gdtype_from_datatype(p_function->parameters[i]->get_datatype(), codegen.script);
+		if (par_type.has_type() && !(argument.type == par_type)) {
+			RuztaCodeGenerator::Address converted = codegen.add_temporary(par_type);
+			gen->write_assign_with_conversion(converted, argument);
+			argument = converted;
+			bound_temporaries++;
+		} else if (argument.mode != RuztaCodeGenerator::Address::CONSTANT && argument.mode != RuztaCodeGenerator::Address::TEMPORARY) {
+			RuztaCodeGenerator::Address copy = codegen.add_temporary(argument.type);
+			gen->write_assign(copy, argument);
+			argument = copy;
+			bound_temporaries++;
+		}
+		parameters[p_function->parameters[i]->identifier->name] = argument;
+	}
+
+	HashMap<StringName, RuztaCodeGenerator::Address> caller_parameters = codegen.parameters;
+	HashMap<StringName, RuztaCodeGenerator::Address> caller_locals = codegen.locals;
+	codegen.parameters = parameters;
+	codegen.locals.clear();
+	codegen.inlined_functions.push_back(p_function);
+
+	const RuztaParser::ReturnNode *return_n = static_cast<const RuztaParser::ReturnNode *>(p_function->body->statements[0]);
+	RuztaCodeGenerator::Address value = _parse_expression(codegen, r_error, return_n->return_value);
+
+	codegen.inlined_functions.resize(codegen.inlined_functions.size() - 1);
+	codegen.parameters = caller_parameters;
+	codegen.locals = caller_locals;
+
+	if (r_error) {
+		return;
+	}
+
+	if (p_result.mode != RuztaCodeGenerator::Address::NIL) {
+		if (p_result.type.has_type() && !(value.type == p_result.type)) {
+			// Same conversion as returning from a typed function.
+			gen->write_assign_with_conversion(p_result, value);
+		} else {
+			gen->write_assign(p_result, value);
+		}
+	}
+
+	// The value may be one of the bound arguments (e.g. `return x`), which are released by the caller.
+	bool owns_value = value.mode == RuztaCodeGenerator::Address::TEMPORARY;
+	for (const KeyValue<StringName, RuztaCodeGenerator::Address> &E : parameters) {
+		if (E.value.mode == RuztaCodeGenerator::Address::TEMPORARY && E.value.address == value.address) {
+			owns_value = false;
+		}
+	}
+	if (owns_value) {
+		gen->pop_temporary();
+	}
+	for (int i = 0; i < bound_temporaries; i++) {
+		gen->pop_temporary();
+	}
+}
+
 RuztaCodeGenerator::Address RuztaCompiler::_parse_expression(CodeGen &codegen, Error &r_error, const RuztaParser::ExpressionNode *p_expression, bool p_root, bool p_initializer) {
 	if (p_expression->is_constant && !(p_expression->get_datatype().is_meta_type && p_expression->get_datatype().kind == RuztaParser::DataType::CLASS)) {
 		return codegen.add_constant(p_expression->reduced_value);
@@ -666,9 +910,17 @@ RuztaCodeGenerator::Address RuztaCompiler::_parse_expression(CodeGen &codegen, E
 				// Regular function.
 				const RuztaParser::ExpressionNode *callee = call->callee;
 
+				const RuztaParser::FunctionNode *inline_function = is_awaited ? nullptr : _get_inline_function(codegen, call);
+
 				if (call->is_super) {
 					// Super call.
 					gen->write_super_call(result, call->function_name, arguments);
+				} else if (inline_function != nullptr) {
+					// Small function, compile its body in place.
+					_parse_inline_call(codegen, r_error, inline_function, result, arguments);
+					if (r_error) {
+						return RuztaCodeGenerator::Address();
+					}
 				} else {
 					if (callee->type == RuztaParser::Node::IDENTIFIER) {
 						// Self function call.
@@ -685,6 +937,9 @@ RuztaCodeGenerator::Address RuztaCompiler::_parse_expression(CodeGen &codegen, E
 								// Not exact arguments, but still can use method bind call.
 								gen->write_call_method_bind(result, self, method, arguments);
 							}
+						} else if (const RuztaParser::FunctionNode *direct_function = is_awaited ? nullptr : _get_direct_call_function(codegen, call)) {
+							// Can't be overridden, call the function without looking it up.
+							gen->write_call_direct(result, call->function_name, arguments, _are_direct_call_arguments_validated(codegen, direct_function, arguments));
 						} else if (call->is_static || codegen.is_static || (codegen.function_node && codegen.function_node->is_static) || call->function_name == StringName("new")) {
 							RuztaCodeGenerator::Address self;
 							self.mode = RuztaCodeGenerator::Address::CLASS;
@@ -814,6 +1069,26 @@ RuztaCodeGenerator::Address RuztaCompiler::_parse_expression(CodeGen &codegen, E
 
 			return result;
 		} break;
+		case RuztaParser::Node::YIELD: {
+			const RuztaParser::YieldNode *yield = static_cast<const RuztaParser::YieldNode *>(p_expression);
+
+			RuztaCodeGenerator::Address result = codegen.add_temporary(_gdtype_from_datatype(p_expression->get_datatype(), codegen.script));
+			RuztaCodeGenerator::Address value;
+			if (yield->value) {
+				value = _parse_expression(codegen, r_error, yield->value);
+				if (r_error) {
+					return RuztaCodeGenerator::Address();
+				}
+			}
+
+			gen->write_yield(result, value);
+
+			if (value.mode == RuztaCodeGenerator::Address::TEMPORARY) {
+				gen->pop_temporary();
+			}
+
+			return result;
+		} break;
 		// Indexing operator.
 		case RuztaParser::Node::SUBSCRIPT: {
 			const RuztaParser::SubscriptNode *subscript = static_cast<const RuztaParser::SubscriptNode *>(p_expression);
@@ -2473,6 +2748,10 @@ RuztaFunction *RuztaCompiler::_parse_function(Error &r_error, Ruzta *p_script, c
 
 	// Parse default argument code if applies.
 	if (p_func) {
+		if (p_func->is_generator) {
+			codegen.generator->write_generator_start();
+		}
+
 		if (optional_parameters > 0) {
 			codegen.generator->start_parameters();
 			for (int i = p_func->parameters.size() - optional_parameters; i < p_func->parameters.size(); i++) {
@@ -2536,6 +2815,9 @@ RuztaFunction *RuztaCompiler::_parse_function(Error &r_error, Ruzta *p_script, c
 	}
 
 	RuztaFunction *rz_function = codegen.generator->write_end();
+	if (!rz_function->direct_call_names.is_empty()) {
+		direct_call_functions.push_back(rz_function);
+	}
 
 	if (is_initializer) {
 		p_script->initializer = rz_function;
@@ -2559,6 +2841,15 @@ RuztaFunction *RuztaCompiler::_parse_function(Error &r_error, Ruzta *p_script, c
 		if (p_func->is_vararg()) {
 			rz_function->_vararg_index = vararg_addr.address;
 		}
+
+		// A suspended frame outlives the call, so its arguments must be owned.
+		if (!p_func->is_coroutine && !p_func->is_generator) {
+			for (int i = 0; i < MIN(p_func->parameters.size(), 64); i++) {
+				if (!p_func->parameters[i]->is_written) {
+					rz_function->_read_only_arguments |= uint64_t(1) << i;
+				}
+			}
+		}
 	}
 
 	rz_function->method_info = method_info;
@@ -2699,6 +2990,9 @@ RuztaFunction *RuztaCompiler::_make_static_initializer(Error &r_error, Ruzta *p_
 	codegen.generator->set_initial_line(p_class->start_line);
 
 	RuztaFunction *rz_function = codegen.generator->write_end();
+	if (!rz_function->direct_call_names.is_empty()) {
+		direct_call_functions.push_back(rz_function);
+	}
 
 	memdelete(codegen.generator);
 
@@ -2757,6 +3051,7 @@ Error RuztaCompiler::_prepare_compilation(Ruzta *p_script, const RuztaParser::Cl
 	for (const KeyValue<StringName, RuztaFunction *> &E : p_script->member_functions) {
 		member_functions.insert(E.key, E.value);
 	}
+	p_script->_invalidate_inheriter_method_tables();
 	p_script->member_functions.clear();
 	for (const KeyValue<StringName, RuztaFunction *> &E : member_functions) {
 		memdelete(E.value);
@@ -2776,7 +3071,10 @@ Error RuztaCompiler::_prepare_compilation(Ruzta *p_script, const RuztaParser::Cl
 	}
 
 	p_script->member_functions.clear();
+	p_script->method_table.clear();
+	p_script->notification_chain.clear();
 	p_script->member_indices.clear();
+	p_script->member_layout_id = 0;
 	p_script->static_variables_indices.clear();
 	p_script->static_variables.clear();
 	p_script->_signals.clear();
@@ -2994,6 +3292,9 @@ Error RuztaCompiler::_prepare_compilation(Ruzta *p_script, const RuztaParser::Cl
 
 	p_script->static_variables.resize(p_script->static_variables_indices.size());
 
+	// Member access caches key on this id, so a recompiled script never matches stale entries.
+	p_script->member_layout_id = Ruzta::new_member_layout_id();
+
 	parsed_classes.insert(p_script);
 	parsing_classes.erase(p_script);
 
@@ -3257,7 +3558,11 @@ RuztaCompiler::ScriptLambdaInfo RuztaCompiler::_get_script_lambda_replacement_in
 	}
 
 	for (const KeyValue<StringName, RuztaFunction *> &E : p_script->member_functions) {
-		info.member_function_infos.insert(E.key, _get_function_lambda_replacement_info(E.value));
+		FunctionLambdaInfo function_info = _get_function_replacement_info(E.value);
+		info.member_function_infos.insert(E.key, function_info.sublambdas);
+		// The function itself may be the target of direct calls.
+		function_info.sublambdas.clear();
+		info.member_function_self_infos.insert(E.key, function_info);
 	}
 
 	for (const KeyValue<StringName, Ref<Ruzta>> &KV : p_script->get_subclasses()) {
@@ -3315,6 +3620,9 @@ void RuztaCompiler::_get_function_ptr_replacements(HashMap<RuztaFunction *, Ruzt
 	for (const KeyValue<StringName, Vector<FunctionLambdaInfo>> &old_kv : p_old_info.member_function_infos) {
 		_get_function_ptr_replacements(r_replacements, old_kv.value, p_new_info != nullptr ? p_new_info->member_function_infos.getptr(old_kv.key) : nullptr);
 	}
+	for (const KeyValue<StringName, FunctionLambdaInfo> &old_kv : p_old_info.member_function_self_infos) {
+		_get_function_ptr_replacements(r_replacements, old_kv.value, p_new_info != nullptr ? p_new_info->member_function_self_infos.getptr(old_kv.key) : nullptr);
+	}
 	for (int i = 0; i < p_old_info.other_function_infos.size(); ++i) {
 		const FunctionLambdaInfo &old_other_info = p_old_info.other_function_infos[i];
 		const FunctionLambdaInfo *new_other_info = nullptr;
@@ -3341,6 +3649,7 @@ Error RuztaCompiler::compile(const RuztaParser *p_parser, Ruzta *p_script, bool
 	const RuztaParser::ClassNode *root = parser->get_tree();
 
 	source = p_script->get_path();
+	direct_call_functions.clear();
 
 	ScriptLambdaInfo old_lambda_info = _get_script_lambda_replacement_info(p_script);
 
@@ -3359,12 +3668,22 @@ Error RuztaCompiler::compile(const RuztaParser *p_parser, Ruzta *p_script, bool
 		return err;
 	}
 
+	// Inner classes may extend classes compiled after them, so flatten once everything is compiled.
+	main_script->_update_method_tables();
+	main_script->_update_inheriter_method_tables();
+
 	ScriptLambdaInfo new_lambda_info = _get_script_lambda_replacement_info(p_script);
 
 	HashMap<RuztaFunction *, RuztaFunction *> func_ptr_replacements;
 	_get_function_ptr_replacements(func_ptr_replacements, old_lambda_info, &new_lambda_info);
 	main_script->_recurse_replace_function_ptrs(func_ptr_replacements);
 
+	// Only now, otherwise the replacement above would reset the new pointers.
+	for (RuztaFunction *function : direct_call_functions) {
+		function->_resolve_direct_calls();
+	}
+	direct_call_functions.clear();
+
 	if (has_static_data && !root->annotated_static_unload) {
 		RuztaCache::add_static_script(p_script);
 	}
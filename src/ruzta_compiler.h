@@ -69,6 +69,7 @@ class RuztaCompiler {
 		Vector<FunctionLambdaInfo> implicit_ready_info;
 		Vector<FunctionLambdaInfo> static_initializer_info;
 		HashMap<StringName, Vector<FunctionLambdaInfo>> member_function_infos;
+		HashMap<StringName, FunctionLambdaInfo> member_function_self_infos; // Without sublambdas, those are in `member_function_infos`.
 		Vector<FunctionLambdaInfo> other_function_infos;
 		HashMap<StringName, ScriptLambdaInfo> subclass_info;
 	};
@@ -82,6 +83,7 @@ class RuztaCompiler {
 		HashMap<StringName, RuztaCodeGenerator::Address> parameters;
 		HashMap<StringName, RuztaCodeGenerator::Address> locals;
 		List<HashMap<StringName, RuztaCodeGenerator::Address>> locals_stack;
+		Vector<const RuztaParser::FunctionNode *> inlined_functions; // Functions being compiled in place, to avoid recursive inlining.
 		bool is_static = false;
 
 		RuztaCodeGenerator::Address add_local(const StringName &p_name, const RuztaDataType &p_type) {
@@ -152,6 +154,10 @@ class RuztaCompiler {
 	RuztaDataType _gdtype_from_datatype(const RuztaParser::DataType &p_datatype, Ruzta *p_owner, bool p_handle_metatype = true);
 
 	RuztaCodeGenerator::Address _parse_expression(CodeGen &codegen, Error &r_error, const RuztaParser::ExpressionNode *p_expression, bool p_root = false, bool p_initializer = false);
+	const RuztaParser::FunctionNode *_get_inline_function(const CodeGen &codegen, const RuztaParser::CallNode *p_call) const;
+	const RuztaParser::FunctionNode *_get_direct_call_function(const CodeGen &codegen, const RuztaParser::CallNode *p_call) const;
+	bool _are_direct_call_arguments_validated(const CodeGen &codegen, const RuztaParser::FunctionNode *p_function, const Vector<RuztaCodeGenerator::Address> &p_arguments);
+	void _parse_inline_call(CodeGen &codegen, Error &r_error, const RuztaParser::FunctionNode *p_function, const RuztaCodeGenerator::Address &p_result, const Vector<RuztaCodeGenerator::Address> &p_arguments);
 	RuztaCodeGenerator::Address _parse_match_pattern(CodeGen &codegen, Error &r_error, const RuztaParser::PatternNode *p_pattern, const RuztaCodeGenerator::Address &p_value_addr, const RuztaCodeGenerator::Address &p_type_addr, const RuztaCodeGenerator::Address &p_previous_test, bool p_is_first, bool p_is_nested);
 	List<RuztaCodeGenerator::Address> _add_block_locals(CodeGen &codegen, const RuztaParser::SuiteNode *p_block);
 	void _clear_block_locals(CodeGen &codegen, const List<RuztaCodeGenerator::Address> &p_locals);
@@ -174,6 +180,7 @@ class RuztaCompiler {
 	String error;
 	RuztaParser::ExpressionNode *awaited_node = nullptr;
 	bool has_static_data = false;
+	Vector<RuztaFunction *> direct_call_functions; // Functions of this compilation with CALL_DIRECT sites, resolved at the end.
 
 public:
 	static void convert_to_initializer_type(Variant &p_variant, const RuztaParser::VariableNode *p_node);
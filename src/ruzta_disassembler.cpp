@@ -100,7 +100,11 @@ static String _disassemble_address(const Ruzta *p_script, const RuztaFunction &p
 	return "<err>";
 }
 
-void RuztaFunction::disassemble(const Vector<String> &p_code_lines) const {
+void RuztaFunction::_disassemble_code(const int *p_code, int p_code_size, const Vector<String> &p_code_lines, Vector<String> &r_lines) const {
+	// Shadow the members so the same decoder serves the final, the decoded compact and the unoptimized code.
+	const int *_code_ptr = p_code;
+	const int _code_size = p_code_size;
+
 #define DADDR(m_ip) (_disassemble_address(_script, *this, _code_ptr[ip + m_ip]))
 
 	for (int ip = 0; ip < _code_size;) {
@@ -115,11 +119,11 @@ void RuztaFunction::disassemble(const Vector<String> &p_code_lines) const {
 		Opcode opcode = Opcode(_code_ptr[ip]);
 
 		switch (opcode) {
-			case OPCODE_OPERATOR: {
-				constexpr int _pointer_size = sizeof(RuztaVariantExtension::ValidatedOperatorEvaluator) / sizeof(*_code_ptr);
+			case OPCODE_OPERATOR:
+			case OPCODE_OPERATOR_QUICKENED: {
 				int operation = _code_ptr[ip + 4];
 
-				text += "operator ";
+				text += opcode == OPCODE_OPERATOR_QUICKENED ? "quickened operator " : "operator ";
 
 				text += DADDR(3);
 				text += " = ";
@@ -129,7 +133,7 @@ void RuztaFunction::disassemble(const Vector<String> &p_code_lines) const {
 				text += " ";
 				text += DADDR(2);
 
-				incr += 7 + _pointer_size;
+				incr += 6;
 			} break;
 			case OPCODE_OPERATOR_VALIDATED: {
 				text += "validated operator ";
@@ -144,6 +148,91 @@ void RuztaFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr += 5;
 			} break;
+
+#define DISASSEMBLE_OPERATOR_UNBOXED(m_name, m_op) \
+	case OPCODE_OPERATOR_##m_name: {               \
+		text += "unboxed operator (";              \
+		text += #m_name;                           \
+		text += ") ";                              \
+		text += DADDR(3);                          \
+		text += " = ";                             \
+		text += DADDR(1);                          \
+		text += " " #m_op " ";                     \
+		text += DADDR(2);                          \
+		incr += 4;                                 \
+	} break
+
+				DISASSEMBLE_OPERATOR_UNBOXED(ADD_INT, +);
+				DISASSEMBLE_OPERATOR_UNBOXED(SUB_INT, -);
+				DISASSEMBLE_OPERATOR_UNBOXED(MUL_INT, *);
+				DISASSEMBLE_OPERATOR_UNBOXED(EQUAL_INT, ==);
+				DISASSEMBLE_OPERATOR_UNBOXED(NOT_EQUAL_INT, !=);
+				DISASSEMBLE_OPERATOR_UNBOXED(LESS_INT, <);
+				DISASSEMBLE_OPERATOR_UNBOXED(LESS_EQUAL_INT, <=);
+				DISASSEMBLE_OPERATOR_UNBOXED(GREATER_INT, >);
+				DISASSEMBLE_OPERATOR_UNBOXED(GREATER_EQUAL_INT, >=);
+				DISASSEMBLE_OPERATOR_UNBOXED(ADD_FLOAT, +);
+				DISASSEMBLE_OPERATOR_UNBOXED(SUB_FLOAT, -);
+				DISASSEMBLE_OPERATOR_UNBOXED(MUL_FLOAT, *);
+				DISASSEMBLE_OPERATOR_UNBOXED(DIV_FLOAT, /);
+				DISASSEMBLE_OPERATOR_UNBOXED(EQUAL_FLOAT, ==);
+				DISASSEMBLE_OPERATOR_UNBOXED(NOT_EQUAL_FLOAT, !=);
+				DISASSEMBLE_OPERATOR_UNBOXED(LESS_FLOAT, <);
+				DISASSEMBLE_OPERATOR_UNBOXED(LESS_EQUAL_FLOAT, <=);
+				DISASSEMBLE_OPERATOR_UNBOXED(GREATER_FLOAT, >);
+				DISASSEMBLE_OPERATOR_UNBOXED(GREATER_EQUAL_FLOAT, >=);
+				DISASSEMBLE_OPERATOR_UNBOXED(ADD_VECTOR2, +);
+				DISASSEMBLE_OPERATOR_UNBOXED(SUB_VECTOR2, -);
+				DISASSEMBLE_OPERATOR_UNBOXED(MUL_VECTOR2, *);
+				DISASSEMBLE_OPERATOR_UNBOXED(MUL_VECTOR2_FLOAT, *);
+				DISASSEMBLE_OPERATOR_UNBOXED(ADD_VECTOR3, +);
+				DISASSEMBLE_OPERATOR_UNBOXED(SUB_VECTOR3, -);
+				DISASSEMBLE_OPERATOR_UNBOXED(MUL_VECTOR3, *);
+				DISASSEMBLE_OPERATOR_UNBOXED(MUL_VECTOR3_FLOAT, *);
+
+			case OPCODE_JUMP_IF_NOT_OPERATOR_VALIDATED: {
+				text += "validated operator ";
+
+				text += DADDR(3);
+				text += " = ";
+				text += DADDR(1);
+				text += " ";
+				text += operator_names[_code_ptr[ip + 4]];
+				text += " ";
+				text += DADDR(2);
+				text += ", jump-if-not to ";
+				text += itos(_code_ptr[ip + 5]);
+
+				incr += 6;
+			} break;
+
+#define DISASSEMBLE_JUMP_IF_NOT_UNBOXED(m_name, m_op) \
+	case OPCODE_JUMP_IF_NOT_##m_name: {               \
+		text += "unboxed operator (";                 \
+		text += #m_name;                              \
+		text += ") ";                                 \
+		text += DADDR(3);                             \
+		text += " = ";                                \
+		text += DADDR(1);                             \
+		text += " " #m_op " ";                        \
+		text += DADDR(2);                             \
+		text += ", jump-if-not to ";                  \
+		text += itos(_code_ptr[ip + 4]);              \
+		incr += 5;                                    \
+	} break
+
+				DISASSEMBLE_JUMP_IF_NOT_UNBOXED(EQUAL_INT, ==);
+				DISASSEMBLE_JUMP_IF_NOT_UNBOXED(NOT_EQUAL_INT, !=);
+				DISASSEMBLE_JUMP_IF_NOT_UNBOXED(LESS_INT, <);
+				DISASSEMBLE_JUMP_IF_NOT_UNBOXED(LESS_EQUAL_INT, <=);
+				DISASSEMBLE_JUMP_IF_NOT_UNBOXED(GREATER_INT, >);
+				DISASSEMBLE_JUMP_IF_NOT_UNBOXED(GREATER_EQUAL_INT, >=);
+				DISASSEMBLE_JUMP_IF_NOT_UNBOXED(EQUAL_FLOAT, ==);
+				DISASSEMBLE_JUMP_IF_NOT_UNBOXED(NOT_EQUAL_FLOAT, !=);
+				DISASSEMBLE_JUMP_IF_NOT_UNBOXED(LESS_FLOAT, <);
+				DISASSEMBLE_JUMP_IF_NOT_UNBOXED(LESS_EQUAL_FLOAT, <=);
+				DISASSEMBLE_JUMP_IF_NOT_UNBOXED(GREATER_FLOAT, >);
+				DISASSEMBLE_JUMP_IF_NOT_UNBOXED(GREATER_EQUAL_FLOAT, >=);
 			case OPCODE_TYPE_TEST_BUILTIN: {
 				text += "type test ";
 				text += DADDR(1);
@@ -240,15 +329,16 @@ void RuztaFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr += 4;
 			} break;
-			case OPCODE_SET_KEYED: {
-				text += "set keyed ";
+			case OPCODE_SET_KEYED:
+			case OPCODE_SET_KEYED_QUICKENED: {
+				text += opcode == OPCODE_SET_KEYED_QUICKENED ? "set keyed quickened " : "set keyed ";
 				text += DADDR(1);
 				text += "[";
 				text += DADDR(2);
 				text += "] = ";
 				text += DADDR(3);
 
-				incr += 4;
+				incr += 5;
 			} break;
 			case OPCODE_SET_KEYED_VALIDATED: {
 				text += "set keyed validated ";
@@ -270,8 +360,9 @@ void RuztaFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr += 5;
 			} break;
-			case OPCODE_GET_KEYED: {
-				text += "get keyed ";
+			case OPCODE_GET_KEYED:
+			case OPCODE_GET_KEYED_QUICKENED: {
+				text += opcode == OPCODE_GET_KEYED_QUICKENED ? "get keyed quickened " : "get keyed ";
 				text += DADDR(3);
 				text += " = ";
 				text += DADDR(1);
@@ -279,7 +370,7 @@ void RuztaFunction::disassemble(const Vector<String> &p_code_lines) const {
 				text += DADDR(2);
 				text += "]";
 
-				incr += 4;
+				incr += 5;
 			} break;
 			case OPCODE_GET_KEYED_VALIDATED: {
 				text += "get keyed validated ";
@@ -303,15 +394,16 @@ void RuztaFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr += 5;
 			} break;
-			case OPCODE_SET_NAMED: {
-				text += "set_named ";
+			case OPCODE_SET_NAMED:
+			case OPCODE_SET_NAMED_QUICKENED: {
+				text += opcode == OPCODE_SET_NAMED_QUICKENED ? "set_named quickened " : "set_named ";
 				text += DADDR(1);
 				text += "[\"";
 				text += _global_names_ptr[_code_ptr[ip + 3]];
 				text += "\"] = ";
 				text += DADDR(2);
 
-				incr += 4;
+				incr += 6;
 			} break;
 			case OPCODE_SET_NAMED_VALIDATED: {
 				text += "set_named validated ";
@@ -323,8 +415,9 @@ void RuztaFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr += 4;
 			} break;
-			case OPCODE_GET_NAMED: {
-				text += "get_named ";
+			case OPCODE_GET_NAMED:
+			case OPCODE_GET_NAMED_QUICKENED: {
+				text += opcode == OPCODE_GET_NAMED_QUICKENED ? "get_named quickened " : "get_named ";
 				text += DADDR(2);
 				text += " = ";
 				text += DADDR(1);
@@ -332,7 +425,7 @@ void RuztaFunction::disassemble(const Vector<String> &p_code_lines) const {
 				text += _global_names_ptr[_code_ptr[ip + 3]];
 				text += "\"]";
 
-				incr += 4;
+				incr += 6;
 			} break;
 			case OPCODE_GET_NAMED_VALIDATED: {
 				text += "get_named validated ";
@@ -364,6 +457,18 @@ void RuztaFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr += 3;
 			} break;
+			case OPCODE_GET_MEMBER_CALL_VALIDATED_RETURN:
+			case OPCODE_GET_MEMBER_CALL_VALIDATED_NO_RETURN: {
+				// The call stays in the code right after, and is printed on its own.
+				text += "get_member ";
+				text += DADDR(1);
+				text += " = ";
+				text += "[\"";
+				text += _global_names_ptr[_code_ptr[ip + 2]];
+				text += "\"], fused with the next call";
+
+				incr += 3;
+			} break;
 			case OPCODE_SET_STATIC_VARIABLE: {
 				Ref<Ruzta> ruzta;
 				if (_code_ptr[ip + 2] == ADDR_CLASS) {
@@ -414,6 +519,17 @@ void RuztaFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr += 3;
 			} break;
+			case OPCODE_ASSIGN_ITERATE_BEGIN:
+			case OPCODE_ASSIGN_ITERATE_BEGIN_ARRAY: {
+				// The for-init stays in the code right after, and is printed on its own.
+				text += "assign ";
+				text += DADDR(1);
+				text += " = ";
+				text += DADDR(2);
+				text += ", fused with the next for-init";
+
+				incr += 3;
+			} break;
 			case OPCODE_ASSIGN_NULL: {
 				text += "assign ";
 				text += DADDR(1);
@@ -711,7 +827,7 @@ void RuztaFunction::disassemble(const Vector<String> &p_code_lines) const {
 				}
 				text += ")";
 
-				incr = 5 + argc;
+				incr = 6 + argc;
 			} break;
 			case OPCODE_CALL_METHOD_BIND:
 			case OPCODE_CALL_METHOD_BIND_RET: {
@@ -987,6 +1103,30 @@ void RuztaFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr = 4 + argc;
 			} break;
+			case OPCODE_CALL_DIRECT:
+			case OPCODE_CALL_DIRECT_VALIDATED: {
+				bool validated = (_code_ptr[ip]) == OPCODE_CALL_DIRECT_VALIDATED;
+
+				int instr_var_args = _code_ptr[++ip];
+
+				text += validated ? "call-direct-validated " : "call-direct ";
+
+				int argc = _code_ptr[ip + 1 + instr_var_args];
+				text += DADDR(1 + argc) + " = ";
+
+				text += direct_call_names[_code_ptr[ip + 2 + instr_var_args]];
+				text += "(";
+
+				for (int i = 0; i < argc; i++) {
+					if (i > 0) {
+						text += ", ";
+					}
+					text += DADDR(1 + i);
+				}
+				text += ")";
+
+				incr = 4 + argc;
+			} break;
 			case OPCODE_AWAIT: {
 				text += "await ";
 				text += DADDR(1);
@@ -999,6 +1139,12 @@ void RuztaFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr = 2;
 			} break;
+			case OPCODE_YIELD: {
+				text += "yield ";
+				text += DADDR(1);
+
+				incr = 2;
+			} break;
 			case OPCODE_CREATE_LAMBDA: {
 				int instr_var_args = _code_ptr[++ip];
 				int captures_count = _code_ptr[ip + 1 + instr_var_args];
@@ -1328,7 +1474,107 @@ void RuztaFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 		ip += incr;
 		if (text.length() > 0) {
-			print_line(text);
+			r_lines.push_back(text);
+		}
+	}
+}
+
+// Compact code is decoded back to ints, both forms read the same once disassembled.
+Vector<int> RuztaFunction::_get_disassembly_code() const {
+	if (!_compact_code_ptr) {
+		return code;
+	}
+	Vector<int> decoded;
+	decoded.resize(_code_size);
+	for (int i = 0; i < _code_size; i++) {
+		decoded.write[i] = decode_compact_unit(_compact_code_ptr[i]);
+	}
+	return decoded;
+}
+
+void RuztaFunction::disassemble(const Vector<String> &p_code_lines) const {
+	if (_compact_code_ptr) {
+		print_line(vformat("Compact code, %d bytes instead of %d.", _code_size * (int)sizeof(uint16_t), _code_size * (int)sizeof(int)));
+	}
+	const Vector<int> disassembly_code = _get_disassembly_code();
+	Vector<String> lines;
+	_disassemble_code(disassembly_code.ptr(), _code_size, p_code_lines, lines);
+	for (const String &line : lines) {
+		print_line(line);
+	}
+}
+
+// The current code, rewrites included, for tests checking which form an instruction runs in.
+PackedStringArray RuztaFunction::get_disassembly() const {
+	const Vector<int> disassembly_code = _get_disassembly_code();
+	Vector<String> lines;
+	_disassemble_code(disassembly_code.ptr(), _code_size, Vector<String>(), lines);
+	PackedStringArray result;
+	for (const String &line : lines) {
+		result.push_back(line);
+	}
+	return result;
+}
+
+// Strips the leading " <ip>: " so shifted instructions still compare equal.
+static String _strip_disassembly_ip(const String &p_line) {
+	int colon = p_line.find(": ");
+	return colon == -1 ? p_line : p_line.substr(colon + 2);
+}
+
+void RuztaFunction::disassemble_optimizer_diff(const Vector<String> &p_code_lines) const {
+	if (unoptimized_code.is_empty()) {
+		return; // The optimizer left this function untouched.
+	}
+
+	Vector<String> before;
+	Vector<String> after;
+	_disassemble_code(unoptimized_code.ptr(), unoptimized_code.size(), p_code_lines, before);
+	const Vector<int> disassembly_code = _get_disassembly_code();
+	_disassemble_code(disassembly_code.ptr(), _code_size, p_code_lines, after);
+
+	const int before_count = before.size();
+	const int after_count = after.size();
+	Vector<String> before_keys;
+	Vector<String> after_keys;
+	for (const String &line : before) {
+		before_keys.push_back(_strip_disassembly_ip(line));
+	}
+	for (const String &line : after) {
+		after_keys.push_back(_strip_disassembly_ip(line));
+	}
+
+	// Longest common subsequence table, lcs[i][j] covers before[i..] and after[j..].
+	const int stride = after_count + 1;
+	Vector<int> lcs;
+	lcs.resize((before_count + 1) * stride);
+	int *lcs_ptr = lcs.ptrw();
+	for (int i = before_count; i >= 0; i--) {
+		for (int j = after_count; j >= 0; j--) {
+			if (i == before_count || j == after_count) {
+				lcs_ptr[i * stride + j] = 0;
+			} else if (before_keys[i] == after_keys[j]) {
+				lcs_ptr[i * stride + j] = lcs_ptr[(i + 1) * stride + j + 1] + 1;
+			} else {
+				lcs_ptr[i * stride + j] = MAX(lcs_ptr[(i + 1) * stride + j], lcs_ptr[i * stride + j + 1]);
+			}
+		}
+	}
+
+	print_line("Optimizer diff:");
+	int i = 0;
+	int j = 0;
+	while (i < before_count || j < after_count) {
+		if (i < before_count && j < after_count && before_keys[i] == after_keys[j]) {
+			print_line("  " + after[j]);
+			i++;
+			j++;
+		} else if (j < after_count && (i == before_count || lcs_ptr[i * stride + j + 1] >= lcs_ptr[(i + 1) * stride + j])) {
+			print_line("+ " + after[j]);
+			j++;
+		} else {
+			print_line("- " + before[i]);
+			i++;
 		}
 	}
 }
@@ -468,7 +468,7 @@ int32_t RuztaLanguage::_debug_get_stack_level_count() const {
 		return 1;
 	}
 
-	return _call_stack_size;
+	return _get_stack_level_count();
 }
 
 int32_t RuztaLanguage::_debug_get_stack_level_line(int32_t p_level) const {
@@ -476,9 +476,9 @@ int32_t RuztaLanguage::_debug_get_stack_level_line(int32_t p_level) const {
 		return _debug_parse_err_line;
 	}
 
-	ERR_FAIL_INDEX_V(p_level, (int)_call_stack_size, -1);
+	ERR_FAIL_INDEX_V(p_level, (int)_get_stack_level_count(), -1);
 
-	return *(_get_stack_level(p_level)->line);
+	return _get_stack_level(p_level)->get_line();
 }
 
 String RuztaLanguage::_debug_get_stack_level_function(int32_t p_level) const {
@@ -486,7 +486,7 @@ String RuztaLanguage::_debug_get_stack_level_function(int32_t p_level) const {
 		return "";
 	}
 
-	ERR_FAIL_INDEX_V(p_level, (int)_call_stack_size, "");
+	ERR_FAIL_INDEX_V(p_level, (int)_get_stack_level_count(), "");
 	RuztaFunction* func = _get_stack_level(p_level)->function;
 	return func ? String(func->get_name()) : "";
 }
@@ -496,7 +496,7 @@ String RuztaLanguage::_debug_get_stack_level_source(int32_t p_level) const {
 		return _debug_parse_err_file;
 	}
 
-	ERR_FAIL_INDEX_V(p_level, (int)_call_stack_size, "");
+	ERR_FAIL_INDEX_V(p_level, (int)_get_stack_level_count(), "");
 	return _get_stack_level(p_level)->function->get_source();
 }
 
@@ -506,14 +506,14 @@ Dictionary RuztaLanguage::_debug_get_stack_level_locals(int32_t p_level, int32_t
 		return locals_dict;
 	}
 
-	ERR_FAIL_INDEX_V(p_level, (int)_call_stack_size, locals_dict);
+	ERR_FAIL_INDEX_V(p_level, (int)_get_stack_level_count(), locals_dict);
 
 	CallLevel* cl = _get_stack_level(p_level);
 	RuztaFunction* f = cl->function;
 
 	List<Pair<StringName, int>> locals;
 
-	f->debug_get_stack_member_state(*cl->line, &locals);
+	f->debug_get_stack_member_state(cl->get_line(), &locals);
 	for (const Pair<StringName, int>& E : locals) {
 		locals_dict[E.first] = cl->stack[E.second];
 	}
@@ -526,7 +526,7 @@ Dictionary RuztaLanguage::_debug_get_stack_level_members(int32_t p_level, int32_
 		return members_dict;
 	}
 
-	ERR_FAIL_INDEX_V(p_level, (int)_call_stack_size, members_dict);
+	ERR_FAIL_INDEX_V(p_level, (int)_get_stack_level_count(), members_dict);
 
 	CallLevel* cl = _get_stack_level(p_level);
 	RuztaInstance* instance = cl->instance;
@@ -551,7 +551,7 @@ void* RuztaLanguage::_debug_get_stack_level_instance(int32_t p_level) {
 		return nullptr;
 	}
 
-	ERR_FAIL_INDEX_V(p_level, (int)_call_stack_size, nullptr);
+	ERR_FAIL_INDEX_V(p_level, (int)_get_stack_level_count(), nullptr);
 
 	return _get_stack_level(p_level)->instance;
 }
@@ -1772,7 +1772,7 @@ static void _find_identifiers(const RuztaParser::CompletionContext& p_context, b
 	}
 
 	static const char* _keywords_with_space[] = {
-		"and", "not", "or", "in", "as", "class", "class_name", "extends", "is", "func", "signal", "await",
+		"and", "not", "or", "in", "as", "class", "class_name", "extends", "is", "func", "signal", "await", "yield",
 		"const", "enum", "static", "var", "if", "elif", "else", "for", "match", "when", "while",
 		nullptr};
 
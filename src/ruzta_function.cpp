@@ -45,6 +45,22 @@ StringName RuztaFunction::get_global_name(int p_idx) const {
 	return global_names[p_idx];
 }
 
+bool RuztaFunction::encode_compact_code(const Vector<int> &p_code, Vector<uint16_t> &r_compact) {
+	r_compact.resize(p_code.size());
+	uint16_t *compact = r_compact.ptrw();
+	for (int i = 0; i < p_code.size(); i++) {
+		const uint32_t value = (uint32_t)p_code[i];
+		const uint32_t address_type = value >> ADDR_BITS;
+		const uint32_t index = value & ADDR_MASK;
+		if (address_type > (0xFFFF >> COMPACT_CODE_INDEX_BITS) || index > COMPACT_CODE_INDEX_MASK) {
+			r_compact.clear();
+			return false;
+		}
+		compact[i] = (uint16_t)((address_type << COMPACT_CODE_INDEX_BITS) | index);
+	}
+	return true;
+}
+
 struct _GDFKC {
 	int order = 0;
 	List<int> pos;
@@ -60,6 +76,22 @@ struct _GDFKCS {
 	}
 };
 
+int RuztaFunction::get_line(int p_ip) const {
+	// Last entry starting at or before `p_ip`.
+	const LineEntry *entries = lines.ptr();
+	int low = 0;
+	int high = lines.size();
+	while (low < high) {
+		const int mid = (low + high) / 2;
+		if (entries[mid].ip <= p_ip) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+	return low > 0 ? entries[low - 1].line : _initial_line;
+}
+
 void RuztaFunction::debug_get_stack_member_state(int p_line, List<Pair<StringName, int>> *r_stackvars) const {
 	int oc = 0;
 	HashMap<StringName, _GDFKC> sdmap;
@@ -107,9 +139,100 @@ void RuztaFunction::debug_get_stack_member_state(int p_line, List<Pair<StringNam
 	}
 }
 
+#ifdef DEBUG_ENABLED
+static SafeNumeric<uint64_t> _profile_last_id;
+// Bumped whenever a function counted by some thread goes away, so threads know to prune their cache.
+static SafeNumeric<uint64_t> _profile_released_count;
+
+// Counts this thread added to, keyed by id so a dead function's entry is never hit again.
+struct RuztaFunction::ProfileThreadCache {
+	HashMap<uint64_t, Profile::ThreadCounts *> counts;
+	uint64_t pruned_at = 0;
+
+	~ProfileThreadCache() {
+		_profile_thread_cache = nullptr;
+		for (const KeyValue<uint64_t, Profile::ThreadCounts *> &E : counts) {
+			Profile::ThreadCounts::release(E.value);
+		}
+	}
+};
+
+RuztaFunction::ProfileThreadCache *RuztaFunction::_create_profile_thread_cache() {
+	// Only constructed here, so only the first counted call of each thread goes through its initialization guard.
+	// Released when the thread exits.
+	static thread_local ProfileThreadCache cache;
+	_profile_thread_cache = &cache;
+	return &cache;
+}
+
+void RuztaFunction::Profile::ThreadCounts::release(ThreadCounts *p_counts) {
+	if (p_counts->owners.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		memdelete(p_counts);
+	}
+}
+
+RuztaFunction::Profile::ThreadCounts *RuztaFunction::_get_profile_thread_counts() {
+	ProfileThreadCache *cache_ptr = _profile_thread_cache;
+	if (unlikely(!cache_ptr)) {
+		cache_ptr = _create_profile_thread_cache();
+	}
+	ProfileThreadCache &cache = *cache_ptr;
+	Profile::ThreadCounts **counts = cache.counts.getptr(profile.id);
+	if (likely(counts != nullptr)) {
+		return *counts;
+	}
+
+	// Only on a miss, drop the entries of functions that went away since the last time.
+	const uint64_t released_count = _profile_released_count.get();
+	if (cache.pruned_at != released_count) {
+		LocalVector<uint64_t> released;
+		for (const KeyValue<uint64_t, Profile::ThreadCounts *> &E : cache.counts) {
+			if (E.value->owners.load(std::memory_order_acquire) == 1) {
+				released.push_back(E.key);
+			}
+		}
+		for (uint64_t id : released) {
+			Profile::ThreadCounts::release(cache.counts[id]);
+			cache.counts.erase(id);
+		}
+		cache.pruned_at = released_count;
+	}
+
+	Profile::ThreadCounts *new_counts = memnew(Profile::ThreadCounts);
+	{
+		MutexLock lock(RuztaLanguage::get_singleton()->mutex);
+		profile.thread_counts.push_back(new_counts);
+	}
+	cache.counts.insert(profile.id, new_counts);
+	return new_counts;
+}
+
+// Must be called with the language lock held. Other threads keep counting meanwhile,
+// whatever they add after being read is picked up by the next merge.
+void RuztaFunction::Profile::merge_thread_counts() {
+	for (ThreadCounts *counts : thread_counts) {
+		const uint64_t counted_calls = counts->call_count.load(std::memory_order_relaxed);
+		const uint64_t counted_self_time = counts->self_time.load(std::memory_order_relaxed);
+		const uint64_t counted_total_time = counts->total_time.load(std::memory_order_relaxed);
+
+		call_count += counted_calls - counts->merged_call_count;
+		self_time += counted_self_time - counts->merged_self_time;
+		total_time += counted_total_time - counts->merged_total_time;
+		frame_call_count += counted_calls - counts->merged_call_count;
+		frame_self_time += counted_self_time - counts->merged_self_time;
+		frame_total_time += counted_total_time - counts->merged_total_time;
+
+		counts->merged_call_count = counted_calls;
+		counts->merged_self_time = counted_self_time;
+		counts->merged_total_time = counted_total_time;
+	}
+}
+#endif
+
 RuztaFunction::RuztaFunction() {
 	name = "<anonymous>";
 #ifdef DEBUG_ENABLED
+	profile.id = _profile_last_id.increment();
 	{
 		MutexLock lock(RuztaLanguage::get_singleton()->mutex);
 		RuztaLanguage::get_singleton()->function_list.add(&function_list);
@@ -118,23 +241,70 @@ RuztaFunction::RuztaFunction() {
 }
 
 RuztaFunction::~RuztaFunction() {
+	// The sampling profiler reads the functions on the call stacks under this lock, also in release builds.
+	MutexLock lock(RuztaLanguage::get_singleton()->mutex);
+
 	get_script()->member_functions.erase(name);
 
 	for (int i = 0; i < lambdas.size(); i++) {
 		memdelete(lambdas[i]);
 	}
 
+	_clear_direct_calls();
+
+	ThreadedOp *threaded_code = _threaded_code_ptr.load(std::memory_order_acquire);
+	if (threaded_code) {
+		memdelete_arr(threaded_code);
+	}
+
 	for (int i = 0; i < argument_types.size(); i++) {
 		argument_types.write[i].script_type_ref = Ref<Script>();
 	}
 	return_type.script_type_ref = Ref<Script>();
 
 #ifdef DEBUG_ENABLED
-	MutexLock lock(RuztaLanguage::get_singleton()->mutex);
 	RuztaLanguage::get_singleton()->function_list.remove(&function_list);
+	for (Profile::ThreadCounts *counts : profile.thread_counts) {
+		Profile::ThreadCounts::release(counts);
+	}
+	if (!profile.thread_counts.is_empty()) {
+		_profile_released_count.increment();
+	}
 #endif
 }
 
+// Called by the compiler once the whole script is compiled, so `method_table` holds the new functions.
+void RuztaFunction::_resolve_direct_calls() {
+	_clear_direct_calls();
+	if (direct_call_names.is_empty()) {
+		return;
+	}
+
+	_direct_calls_count = direct_call_names.size();
+	_direct_calls_ptr = memnew_arr(DirectCall, _direct_calls_count);
+	for (int i = 0; i < _direct_calls_count; i++) {
+		DirectCall &direct_call = _direct_calls_ptr[i];
+		direct_call.name = direct_call_names[i];
+		HashMap<StringName, RuztaFunction *>::ConstIterator E = _script->method_table.find(direct_call.name);
+		if (E) {
+			direct_call.function = memnew(Ruzta::UpdatableFuncPtr(E->value));
+		}
+	}
+}
+
+void RuztaFunction::_clear_direct_calls() {
+	for (int i = 0; i < _direct_calls_count; i++) {
+		if (_direct_calls_ptr[i].function) {
+			memdelete(_direct_calls_ptr[i].function);
+		}
+	}
+	if (_direct_calls_ptr) {
+		memdelete_arr(_direct_calls_ptr);
+	}
+	_direct_calls_ptr = nullptr;
+	_direct_calls_count = 0;
+}
+
 /////////////////////
 
 Variant RuztaFunctionState::_signal_callback(const Variant **p_args, int p_argcount, GDExtensionCallError &r_error) {
@@ -191,6 +361,12 @@ bool RuztaFunctionState::is_valid(bool p_extended_check) const {
 }
 
 Variant RuztaFunctionState::resume(const Variant &p_arg) {
+	if (is_generator()) {
+		Variant value;
+		resume_generator(value, p_arg);
+		return value;
+	}
+
 	ERR_FAIL_NULL_V(function, Variant());
 	{
 		MutexLock lock(RuztaLanguage::singleton->mutex);
@@ -241,6 +417,64 @@ Variant RuztaFunctionState::resume(const Variant &p_arg) {
 	return ret;
 }
 
+bool RuztaFunctionState::resume_generator(Variant &r_value, const Variant &p_arg) {
+	if (function == nullptr) {
+		// Already ran to the end.
+		r_value = Variant();
+		return false;
+	}
+	{
+		MutexLock lock(RuztaLanguage::singleton->mutex);
+
+		if (!scripts_list.in_list()) {
+			r_value = Variant();
+#ifdef DEBUG_ENABLED
+			ERR_FAIL_V_MSG(false, "Resumed generator '" + state.function_name + "()', but script is gone. At script: " + state.script_path + ":" + itos(state.line));
+#else
+			return false;
+#endif
+		}
+		if (state.instance && !instances_list.in_list()) {
+			r_value = Variant();
+#ifdef DEBUG_ENABLED
+			ERR_FAIL_V_MSG(false, "Resumed generator '" + state.function_name + "()', but class instance is gone. At script: " + state.script_path + ":" + itos(state.line));
+#else
+			return false;
+#endif
+		}
+		// Not pending while it runs, `yield` puts it back.
+		scripts_list.remove_from_list();
+		instances_list.remove_from_list();
+	}
+
+	state.result = p_arg;
+	state.yielded = false;
+	GDExtensionCallError err;
+	r_value = function->call(nullptr, nullptr, 0, err, &state);
+	state.result = Variant();
+
+	if (state.yielded) {
+		return true;
+	}
+
+	function = nullptr;
+	r_value = Variant();
+	_clear_stack();
+	return false;
+}
+
+bool RuztaFunctionState::_iter_init(const Variant &p_iter) {
+	return resume_generator(yielded_value);
+}
+
+bool RuztaFunctionState::_iter_next(const Variant &p_iter) {
+	return resume_generator(yielded_value);
+}
+
+Variant RuztaFunctionState::_iter_get(const Variant &p_iter) const {
+	return yielded_value;
+}
+
 void RuztaFunctionState::_clear_stack() {
 	if (state.stack_size) {
 		Variant *stack = (Variant *)state.stack.ptr();
@@ -253,6 +487,358 @@ void RuztaFunctionState::_clear_stack() {
 	}
 }
 
+#ifdef RUZTA_OPCODE_STATS
+static const char *_opcode_names[] = {
+	"OPERATOR",
+	"OPERATOR_VALIDATED",
+	"OPERATOR_QUICKENED",
+	"OPERATOR_ADD_INT",
+	"OPERATOR_SUB_INT",
+	"OPERATOR_MUL_INT",
+	"OPERATOR_EQUAL_INT",
+	"OPERATOR_NOT_EQUAL_INT",
+	"OPERATOR_LESS_INT",
+	"OPERATOR_LESS_EQUAL_INT",
+	"OPERATOR_GREATER_INT",
+	"OPERATOR_GREATER_EQUAL_INT",
+	"OPERATOR_ADD_FLOAT",
+	"OPERATOR_SUB_FLOAT",
+	"OPERATOR_MUL_FLOAT",
+	"OPERATOR_DIV_FLOAT",
+	"OPERATOR_EQUAL_FLOAT",
+	"OPERATOR_NOT_EQUAL_FLOAT",
+	"OPERATOR_LESS_FLOAT",
+	"OPERATOR_LESS_EQUAL_FLOAT",
+	"OPERATOR_GREATER_FLOAT",
+	"OPERATOR_GREATER_EQUAL_FLOAT",
+	"OPERATOR_ADD_VECTOR2",
+	"OPERATOR_SUB_VECTOR2",
+	"OPERATOR_MUL_VECTOR2",
+	"OPERATOR_MUL_VECTOR2_FLOAT",
+	"OPERATOR_ADD_VECTOR3",
+	"OPERATOR_SUB_VECTOR3",
+	"OPERATOR_MUL_VECTOR3",
+	"OPERATOR_MUL_VECTOR3_FLOAT",
+	"JUMP_IF_NOT_OPERATOR_VALIDATED",
+	"JUMP_IF_NOT_EQUAL_INT",
+	"JUMP_IF_NOT_NOT_EQUAL_INT",
+	"JUMP_IF_NOT_LESS_INT",
+	"JUMP_IF_NOT_LESS_EQUAL_INT",
+	"JUMP_IF_NOT_GREATER_INT",
+	"JUMP_IF_NOT_GREATER_EQUAL_INT",
+	"JUMP_IF_NOT_EQUAL_FLOAT",
+	"JUMP_IF_NOT_NOT_EQUAL_FLOAT",
+	"JUMP_IF_NOT_LESS_FLOAT",
+	"JUMP_IF_NOT_LESS_EQUAL_FLOAT",
+	"JUMP_IF_NOT_GREATER_FLOAT",
+	"JUMP_IF_NOT_GREATER_EQUAL_FLOAT",
+	"GET_MEMBER_CALL_VALIDATED_RETURN",
+	"GET_MEMBER_CALL_VALIDATED_NO_RETURN",
+	"ASSIGN_ITERATE_BEGIN",
+	"ASSIGN_ITERATE_BEGIN_ARRAY",
+	"TYPE_TEST_BUILTIN",
+	"TYPE_TEST_ARRAY",
+	"TYPE_TEST_DICTIONARY",
+	"TYPE_TEST_NATIVE",
+	"TYPE_TEST_SCRIPT",
+	"SET_KEYED",
+	"SET_KEYED_VALIDATED",
+	"SET_INDEXED_VALIDATED",
+	"SET_KEYED_QUICKENED",
+	"GET_KEYED",
+	"GET_KEYED_VALIDATED",
+	"GET_INDEXED_VALIDATED",
+	"GET_KEYED_QUICKENED",
+	"SET_NAMED",
+	"SET_NAMED_VALIDATED",
+	"SET_NAMED_QUICKENED",
+	"GET_NAMED",
+	"GET_NAMED_VALIDATED",
+	"GET_NAMED_QUICKENED",
+	"SET_MEMBER",
+	"GET_MEMBER",
+	"SET_STATIC_VARIABLE",
+	"GET_STATIC_VARIABLE",
+	"ASSIGN",
+	"ASSIGN_NULL",
+	"ASSIGN_TRUE",
+	"ASSIGN_FALSE",
+	"ASSIGN_TYPED_BUILTIN",
+	"ASSIGN_TYPED_ARRAY",
+	"ASSIGN_TYPED_DICTIONARY",
+	"ASSIGN_TYPED_NATIVE",
+	"ASSIGN_TYPED_SCRIPT",
+	"CAST_TO_BUILTIN",
+	"CAST_TO_NATIVE",
+	"CAST_TO_SCRIPT",
+	"CONSTRUCT",
+	"CONSTRUCT_VALIDATED",
+	"CONSTRUCT_ARRAY",
+	"CONSTRUCT_TYPED_ARRAY",
+	"CONSTRUCT_DICTIONARY",
+	"CONSTRUCT_TYPED_DICTIONARY",
+	"CALL",
+	"CALL_RETURN",
+	"CALL_ASYNC",
+	"CALL_UTILITY",
+	"CALL_UTILITY_VALIDATED",
+	"CALL_RUZTA_UTILITY",
+	"CALL_BUILTIN_TYPE_VALIDATED",
+	"CALL_SELF_BASE",
+	"CALL_DIRECT",
+	"CALL_DIRECT_VALIDATED",
+	"CALL_METHOD_BIND",
+	"CALL_METHOD_BIND_RET",
+	"CALL_BUILTIN_STATIC",
+	"CALL_NATIVE_STATIC",
+	"CALL_NATIVE_STATIC_VALIDATED_RETURN",
+	"CALL_NATIVE_STATIC_VALIDATED_NO_RETURN",
+	"CALL_METHOD_BIND_VALIDATED_RETURN",
+	"CALL_METHOD_BIND_VALIDATED_NO_RETURN",
+	"AWAIT",
+	"AWAIT_RESUME",
+	"YIELD",
+	"CREATE_LAMBDA",
+	"CREATE_SELF_LAMBDA",
+	"JUMP",
+	"JUMP_IF",
+	"JUMP_IF_NOT",
+	"JUMP_TO_DEF_ARGUMENT",
+	"JUMP_IF_SHARED",
+	"RETURN",
+	"RETURN_TYPED_BUILTIN",
+	"RETURN_TYPED_ARRAY",
+	"RETURN_TYPED_DICTIONARY",
+	"RETURN_TYPED_NATIVE",
+	"RETURN_TYPED_SCRIPT",
+	"ITERATE_BEGIN",
+	"ITERATE_BEGIN_INT",
+	"ITERATE_BEGIN_FLOAT",
+	"ITERATE_BEGIN_VECTOR2",
+	"ITERATE_BEGIN_VECTOR2I",
+	"ITERATE_BEGIN_VECTOR3",
+	"ITERATE_BEGIN_VECTOR3I",
+	"ITERATE_BEGIN_STRING",
+	"ITERATE_BEGIN_DICTIONARY",
+	"ITERATE_BEGIN_ARRAY",
+	"ITERATE_BEGIN_PACKED_BYTE_ARRAY",
+	"ITERATE_BEGIN_PACKED_INT32_ARRAY",
+	"ITERATE_BEGIN_PACKED_INT64_ARRAY",
+	"ITERATE_BEGIN_PACKED_FLOAT32_ARRAY",
+	"ITERATE_BEGIN_PACKED_FLOAT64_ARRAY",
+	"ITERATE_BEGIN_PACKED_STRING_ARRAY",
+	"ITERATE_BEGIN_PACKED_VECTOR2_ARRAY",
+	"ITERATE_BEGIN_PACKED_VECTOR3_ARRAY",
+	"ITERATE_BEGIN_PACKED_COLOR_ARRAY",
+	"ITERATE_BEGIN_PACKED_VECTOR4_ARRAY",
+	"ITERATE_BEGIN_OBJECT",
+	"ITERATE_BEGIN_RANGE",
+	"ITERATE",
+	"ITERATE_INT",
+	"ITERATE_FLOAT",
+	"ITERATE_VECTOR2",
+	"ITERATE_VECTOR2I",
+	"ITERATE_VECTOR3",
+	"ITERATE_VECTOR3I",
+	"ITERATE_STRING",
+	"ITERATE_DICTIONARY",
+	"ITERATE_ARRAY",
+	"ITERATE_PACKED_BYTE_ARRAY",
+	"ITERATE_PACKED_INT32_ARRAY",
+	"ITERATE_PACKED_INT64_ARRAY",
+	"ITERATE_PACKED_FLOAT32_ARRAY",
+	"ITERATE_PACKED_FLOAT64_ARRAY",
+	"ITERATE_PACKED_STRING_ARRAY",
+	"ITERATE_PACKED_VECTOR2_ARRAY",
+	"ITERATE_PACKED_VECTOR3_ARRAY",
+	"ITERATE_PACKED_COLOR_ARRAY",
+	"ITERATE_PACKED_VECTOR4_ARRAY",
+	"ITERATE_OBJECT",
+	"ITERATE_RANGE",
+	"STORE_GLOBAL",
+	"STORE_NAMED_GLOBAL",
+	"TYPE_ADJUST_BOOL",
+	"TYPE_ADJUST_INT",
+	"TYPE_ADJUST_FLOAT",
+	"TYPE_ADJUST_STRING",
+	"TYPE_ADJUST_VECTOR2",
+	"TYPE_ADJUST_VECTOR2I",
+	"TYPE_ADJUST_RECT2",
+	"TYPE_ADJUST_RECT2I",
+	"TYPE_ADJUST_VECTOR3",
+	"TYPE_ADJUST_VECTOR3I",
+	"TYPE_ADJUST_TRANSFORM2D",
+	"TYPE_ADJUST_VECTOR4",
+	"TYPE_ADJUST_VECTOR4I",
+	"TYPE_ADJUST_PLANE",
+	"TYPE_ADJUST_QUATERNION",
+	"TYPE_ADJUST_AABB",
+	"TYPE_ADJUST_BASIS",
+	"TYPE_ADJUST_TRANSFORM3D",
+	"TYPE_ADJUST_PROJECTION",
+	"TYPE_ADJUST_COLOR",
+	"TYPE_ADJUST_STRING_NAME",
+	"TYPE_ADJUST_NODE_PATH",
+	"TYPE_ADJUST_RID",
+	"TYPE_ADJUST_OBJECT",
+	"TYPE_ADJUST_CALLABLE",
+	"TYPE_ADJUST_SIGNAL",
+	"TYPE_ADJUST_DICTIONARY",
+	"TYPE_ADJUST_ARRAY",
+	"TYPE_ADJUST_PACKED_BYTE_ARRAY",
+	"TYPE_ADJUST_PACKED_INT32_ARRAY",
+	"TYPE_ADJUST_PACKED_INT64_ARRAY",
+	"TYPE_ADJUST_PACKED_FLOAT32_ARRAY",
+	"TYPE_ADJUST_PACKED_FLOAT64_ARRAY",
+	"TYPE_ADJUST_PACKED_STRING_ARRAY",
+	"TYPE_ADJUST_PACKED_VECTOR2_ARRAY",
+	"TYPE_ADJUST_PACKED_VECTOR3_ARRAY",
+	"TYPE_ADJUST_PACKED_COLOR_ARRAY",
+	"TYPE_ADJUST_PACKED_VECTOR4_ARRAY",
+	"ASSERT",
+	"BREAKPOINT",
+	"LINE",
+	"END",
+};
+static_assert(std_size(_opcode_names) == RuztaOpcodeStats::OPCODE_COUNT, "Opcode names aren't the same as opcodes in enum.");
+
+static Mutex _opcode_stats_mutex;
+static Vector<RuztaOpcodeStats *> _opcode_stats_threads;
+static thread_local RuztaOpcodeStats *_opcode_stats_thread = nullptr;
+
+RuztaOpcodeStats::Recorder::Recorder(const RuztaFunction *p_function) {
+	if (unlikely(_opcode_stats_thread == nullptr)) {
+		// Buffers outlive their thread so its counts still show up in reports.
+		_opcode_stats_thread = memnew(RuztaOpcodeStats);
+		MutexLock lock(_opcode_stats_mutex);
+		_opcode_stats_threads.push_back(_opcode_stats_thread);
+	}
+	stats = _opcode_stats_thread;
+
+	FunctionCounts **counts = stats->functions.getptr(p_function);
+	if (counts == nullptr) {
+		MutexLock lock(_opcode_stats_mutex); // Reports iterate the map.
+		function = memnew(FunctionCounts);
+		function->name = String(p_function->get_source()) + "::" + String(p_function->get_name());
+		stats->functions.insert(p_function, function);
+	} else {
+		function = *counts;
+	}
+}
+
+// Only the owning thread inserts, under the lock so reports can iterate safely.
+void RuztaOpcodeStats::FunctionCounts::add_pair(uint32_t p_pair) {
+	MutexLock lock(_opcode_stats_mutex);
+	pairs.insert(p_pair, 1);
+}
+
+RuztaOpcodeStats::~RuztaOpcodeStats() {
+	for (const KeyValue<const RuztaFunction *, FunctionCounts *> &E : functions) {
+		memdelete(E.value);
+	}
+}
+
+const char *RuztaOpcodeStats::get_opcode_name(int p_opcode) {
+	ERR_FAIL_INDEX_V(p_opcode, OPCODE_COUNT, "<invalid>");
+	return _opcode_names[p_opcode];
+}
+
+static String _get_opcode_pair_name(uint32_t p_pair) {
+	return String(RuztaOpcodeStats::get_opcode_name(p_pair / RuztaOpcodeStats::OPCODE_COUNT)) + " -> " + RuztaOpcodeStats::get_opcode_name(p_pair % RuztaOpcodeStats::OPCODE_COUNT);
+}
+
+// Counts are read without stopping running scripts, so a report taken
+// while other threads execute may be slightly behind.
+Dictionary RuztaOpcodeStats::get_report() {
+	MutexLock lock(_opcode_stats_mutex);
+
+	Vector<uint64_t> opcode_totals;
+	opcode_totals.resize(OPCODE_COUNT);
+	HashMap<uint32_t, uint64_t> pair_totals;
+	HashMap<String, Dictionary> function_reports;
+	for (int i = 0; i < OPCODE_COUNT; i++) {
+		opcode_totals.write[i] = 0;
+	}
+
+	for (const RuztaOpcodeStats *thread_stats : _opcode_stats_threads) {
+		for (int i = 0; i < OPCODE_COUNT; i++) {
+			opcode_totals.write[i] += thread_stats->opcodes[i];
+		}
+		for (int i = 0; i < OPCODE_COUNT * OPCODE_COUNT; i++) {
+			if (thread_stats->pairs[i] > 0) {
+				pair_totals[i] += thread_stats->pairs[i];
+			}
+		}
+
+		for (const KeyValue<const RuztaFunction *, FunctionCounts *> &E : thread_stats->functions) {
+			const FunctionCounts *counts = E.value;
+			if (!function_reports.has(counts->name)) {
+				Dictionary function_report;
+				function_report["opcodes"] = Dictionary();
+				function_report["pairs"] = Dictionary();
+				function_reports[counts->name] = function_report;
+			}
+			Dictionary function_opcodes = function_reports[counts->name]["opcodes"];
+			Dictionary function_pairs = function_reports[counts->name]["pairs"];
+			for (int i = 0; i < OPCODE_COUNT; i++) {
+				if (counts->opcodes[i] > 0) {
+					const String opcode_name = get_opcode_name(i);
+					function_opcodes[opcode_name] = (uint64_t)function_opcodes.get(opcode_name, 0) + counts->opcodes[i];
+				}
+			}
+			for (const KeyValue<uint32_t, uint64_t> &P : counts->pairs) {
+				if (P.value == 0) {
+					continue;
+				}
+				const String pair_name = _get_opcode_pair_name(P.key);
+				function_pairs[pair_name] = (uint64_t)function_pairs.get(pair_name, 0) + P.value;
+			}
+		}
+	}
+
+	Dictionary opcodes_report;
+	for (int i = 0; i < OPCODE_COUNT; i++) {
+		if (opcode_totals[i] > 0) {
+			opcodes_report[get_opcode_name(i)] = opcode_totals[i];
+		}
+	}
+	Dictionary pairs_report;
+	for (const KeyValue<uint32_t, uint64_t> &P : pair_totals) {
+		pairs_report[_get_opcode_pair_name(P.key)] = P.value;
+	}
+	Dictionary functions_report;
+	for (const KeyValue<String, Dictionary> &E : function_reports) {
+		functions_report[E.key] = E.value;
+	}
+
+	Dictionary report;
+	report["opcodes"] = opcodes_report;
+	report["pairs"] = pairs_report;
+	report["functions"] = functions_report;
+	return report;
+}
+
+void RuztaOpcodeStats::reset() {
+	MutexLock lock(_opcode_stats_mutex);
+	for (RuztaOpcodeStats *thread_stats : _opcode_stats_threads) {
+		for (int i = 0; i < OPCODE_COUNT; i++) {
+			thread_stats->opcodes[i] = 0;
+		}
+		for (int i = 0; i < OPCODE_COUNT * OPCODE_COUNT; i++) {
+			thread_stats->pairs[i] = 0;
+		}
+		for (const KeyValue<const RuztaFunction *, FunctionCounts *> &E : thread_stats->functions) {
+			for (int i = 0; i < OPCODE_COUNT; i++) {
+				E.value->opcodes[i] = 0;
+			}
+			for (KeyValue<uint32_t, uint64_t> &P : E.value->pairs) {
+				P.value = 0; // Owning threads may be looking up entries, keep them.
+			}
+		}
+	}
+}
+#endif // RUZTA_OPCODE_STATS
+
 void RuztaFunctionState::_clear_connections() {
 	// TODO
 	// List<Object::Connection> conns;
@@ -267,6 +853,9 @@ void RuztaFunctionState::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("resume", "arg"), &RuztaFunctionState::resume, DEFVAL(Variant()));
 	ClassDB::bind_method(D_METHOD("is_valid", "extended_check"), &RuztaFunctionState::is_valid, DEFVAL(false));
 	ClassDB::bind_vararg_method(METHOD_FLAGS_DEFAULT, "_signal_callback", &RuztaFunctionState::_signal_callback, MethodInfo("_signal_callback"));
+	ClassDB::bind_method(D_METHOD("_iter_init", "iter"), &RuztaFunctionState::_iter_init);
+	ClassDB::bind_method(D_METHOD("_iter_next", "iter"), &RuztaFunctionState::_iter_next);
+	ClassDB::bind_method(D_METHOD("_iter_get", "iter"), &RuztaFunctionState::_iter_get);
 
 	ADD_SIGNAL(MethodInfo("completed", PropertyInfo(Variant::NIL, "result", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NIL_IS_VARIANT)));
 }
@@ -282,4 +871,9 @@ RuztaFunctionState::~RuztaFunctionState() {
 		scripts_list.remove_from_list();
 		instances_list.remove_from_list();
 	}
+
+	if (is_generator()) {
+		// A generator that was not iterated to the end still owns its frame.
+		_clear_stack();
+	}
 }
@@ -40,13 +40,17 @@
 #include <godot_cpp/classes/script_language.hpp> // original: core/object/script_language.h
 #include <godot_cpp/classes/thread.hpp> // original: core/os/thread.h
 #include <godot_cpp/variant/string_name.hpp> // original: core/string/string_name.h
+#include <godot_cpp/templates/local_vector.hpp> // original: core/templates/local_vector.h
 #include <godot_cpp/templates/pair.hpp> // original: core/templates/pair.h
 #include <godot_cpp/templates/self_list.hpp> // original: core/templates/self_list.h
 #include <godot_cpp/variant/variant.hpp> // original: core/variant/variant.h
 #include <godot_cpp/classes/script.hpp> // original:
 
+#include <atomic>
+
 class RuztaInstance;
 class Ruzta;
+class RuztaFunctionState;
 
 class RuztaDataType {
 public:
@@ -268,6 +272,51 @@ public:
 	enum Opcode {
 		OPCODE_OPERATOR,
 		OPCODE_OPERATOR_VALIDATED,
+		OPCODE_OPERATOR_QUICKENED,
+		OPCODE_OPERATOR_ADD_INT,
+		OPCODE_OPERATOR_SUB_INT,
+		OPCODE_OPERATOR_MUL_INT,
+		OPCODE_OPERATOR_EQUAL_INT,
+		OPCODE_OPERATOR_NOT_EQUAL_INT,
+		OPCODE_OPERATOR_LESS_INT,
+		OPCODE_OPERATOR_LESS_EQUAL_INT,
+		OPCODE_OPERATOR_GREATER_INT,
+		OPCODE_OPERATOR_GREATER_EQUAL_INT,
+		OPCODE_OPERATOR_ADD_FLOAT,
+		OPCODE_OPERATOR_SUB_FLOAT,
+		OPCODE_OPERATOR_MUL_FLOAT,
+		OPCODE_OPERATOR_DIV_FLOAT,
+		OPCODE_OPERATOR_EQUAL_FLOAT,
+		OPCODE_OPERATOR_NOT_EQUAL_FLOAT,
+		OPCODE_OPERATOR_LESS_FLOAT,
+		OPCODE_OPERATOR_LESS_EQUAL_FLOAT,
+		OPCODE_OPERATOR_GREATER_FLOAT,
+		OPCODE_OPERATOR_GREATER_EQUAL_FLOAT,
+		OPCODE_OPERATOR_ADD_VECTOR2,
+		OPCODE_OPERATOR_SUB_VECTOR2,
+		OPCODE_OPERATOR_MUL_VECTOR2,
+		OPCODE_OPERATOR_MUL_VECTOR2_FLOAT,
+		OPCODE_OPERATOR_ADD_VECTOR3,
+		OPCODE_OPERATOR_SUB_VECTOR3,
+		OPCODE_OPERATOR_MUL_VECTOR3,
+		OPCODE_OPERATOR_MUL_VECTOR3_FLOAT,
+		OPCODE_JUMP_IF_NOT_OPERATOR_VALIDATED,
+		OPCODE_JUMP_IF_NOT_EQUAL_INT,
+		OPCODE_JUMP_IF_NOT_NOT_EQUAL_INT,
+		OPCODE_JUMP_IF_NOT_LESS_INT,
+		OPCODE_JUMP_IF_NOT_LESS_EQUAL_INT,
+		OPCODE_JUMP_IF_NOT_GREATER_INT,
+		OPCODE_JUMP_IF_NOT_GREATER_EQUAL_INT,
+		OPCODE_JUMP_IF_NOT_EQUAL_FLOAT,
+		OPCODE_JUMP_IF_NOT_NOT_EQUAL_FLOAT,
+		OPCODE_JUMP_IF_NOT_LESS_FLOAT,
+		OPCODE_JUMP_IF_NOT_LESS_EQUAL_FLOAT,
+		OPCODE_JUMP_IF_NOT_GREATER_FLOAT,
+		OPCODE_JUMP_IF_NOT_GREATER_EQUAL_FLOAT,
+		OPCODE_GET_MEMBER_CALL_VALIDATED_RETURN,
+		OPCODE_GET_MEMBER_CALL_VALIDATED_NO_RETURN,
+		OPCODE_ASSIGN_ITERATE_BEGIN,
+		OPCODE_ASSIGN_ITERATE_BEGIN_ARRAY,
 		OPCODE_TYPE_TEST_BUILTIN,
 		OPCODE_TYPE_TEST_ARRAY,
 		OPCODE_TYPE_TEST_DICTIONARY,
@@ -276,13 +325,17 @@ public:
 		OPCODE_SET_KEYED,
 		OPCODE_SET_KEYED_VALIDATED,
 		OPCODE_SET_INDEXED_VALIDATED,
+		OPCODE_SET_KEYED_QUICKENED,
 		OPCODE_GET_KEYED,
 		OPCODE_GET_KEYED_VALIDATED,
 		OPCODE_GET_INDEXED_VALIDATED,
+		OPCODE_GET_KEYED_QUICKENED,
 		OPCODE_SET_NAMED,
 		OPCODE_SET_NAMED_VALIDATED,
+		OPCODE_SET_NAMED_QUICKENED,
 		OPCODE_GET_NAMED,
 		OPCODE_GET_NAMED_VALIDATED,
+		OPCODE_GET_NAMED_QUICKENED,
 		OPCODE_SET_MEMBER,
 		OPCODE_GET_MEMBER,
 		OPCODE_SET_STATIC_VARIABLE, // Only for Ruzta.
@@ -313,6 +366,8 @@ public:
 		OPCODE_CALL_RUZTA_UTILITY,
 		OPCODE_CALL_BUILTIN_TYPE_VALIDATED,
 		OPCODE_CALL_SELF_BASE,
+		OPCODE_CALL_DIRECT,
+		OPCODE_CALL_DIRECT_VALIDATED,
 		OPCODE_CALL_METHOD_BIND,
 		OPCODE_CALL_METHOD_BIND_RET,
 		OPCODE_CALL_BUILTIN_STATIC,
@@ -323,6 +378,7 @@ public:
 		OPCODE_CALL_METHOD_BIND_VALIDATED_NO_RETURN,
 		OPCODE_AWAIT,
 		OPCODE_AWAIT_RESUME,
+		OPCODE_YIELD,
 		OPCODE_CREATE_LAMBDA,
 		OPCODE_CREATE_SELF_LAMBDA,
 		OPCODE_JUMP,
@@ -446,6 +502,43 @@ public:
 		ADDR_NIL = ADDR_STACK_NIL | (ADDR_TYPE_STACK << ADDR_BITS),
 	};
 
+	// Generic instructions keep a type cache in their SiteCache and rewrite themselves into their
+	// quickened form once the cached signature has matched QUICKEN_WARMUP times
+	// in a row. A quickened instruction that fails its type guard reverts to the
+	// generic form, and after QUICKEN_MAX_DEOPTS reverts it stays generic.
+	enum Quickening {
+		QUICKEN_WARMUP = 16,
+		QUICKEN_MAX_DEOPTS = 4,
+		QUICKEN_SIGNATURE_NONE = -1, // Operand types seen can't be quickened.
+		QUICKEN_INDEXED = 1 << 24, // Keyed access resolved to an indexed getter or setter.
+		QUICKEN_VALUE_GUARD = 1 << 25, // Guard also checks the type of the assigned value.
+		QUICKEN_ELEMENT_GUARD = 1 << 26, // Guard also checks the assigned value against the element type of a typed Array.
+	};
+
+	// With threaded dispatch enabled, a function called THREADED_DISPATCH_CALLS times
+	// gets a table with the handler address of each instruction, so dispatching
+	// no longer goes through the opcode. It then runs a separate instantiation of
+	// the dispatch loop, the default one never checks for the table. Only available
+	// with computed goto.
+	enum {
+		THREADED_DISPATCH_CALLS = 1000,
+	};
+
+	// With compact bytecode enabled, functions whose code only holds small values keep it as
+	// 16-bit units instead of ints. A unit has the address type in its top two bits and the
+	// value or address index in the others, so a position means the same in both forms and
+	// jump targets, lines and resumed states need no translation. Functions with larger values
+	// keep the int code. Compact functions never get threaded dispatch.
+	enum {
+		COMPACT_CODE_INDEX_BITS = 14,
+		COMPACT_CODE_INDEX_MASK = (1 << COMPACT_CODE_INDEX_BITS) - 1,
+	};
+
+	_FORCE_INLINE_ static int decode_compact_unit(uint16_t p_unit) {
+		return (p_unit & COMPACT_CODE_INDEX_MASK) | ((p_unit >> COMPACT_CODE_INDEX_BITS) << ADDR_BITS);
+	}
+	static bool encode_compact_code(const Vector<int> &p_code, Vector<uint16_t> &r_compact);
+
 	struct StackDebug {
 		int line;
 		int pos;
@@ -453,6 +546,12 @@ public:
 		StringName identifier;
 	};
 
+	// Source line of the code from `ip` up to the next entry.
+	struct LineEntry {
+		int ip = 0;
+		int line = 0;
+	};
+
 private:
 	friend class Ruzta;
 	friend class RuztaCompiler;
@@ -462,6 +561,9 @@ private:
 	StringName name;
 	StringName source;
 	bool _static = false;
+	bool _coroutine = false; // Contains an `await`, so its frame is allocated on the heap.
+	bool _generator = false; // Contains a `yield`, calling it returns a RuztaFunctionState that runs the body when iterated.
+	bool _line_opcodes = false; // Compiled with OPCODE_LINE, so breakpoints and stepping can stop in it.
 	Vector<RuztaDataType> argument_types;
 	RuztaDataType return_type;
 	MethodInfo method_info;
@@ -471,15 +573,108 @@ private:
 	int _initial_line = 0;
 	int _argument_count = 0;
 	int _vararg_index = -1;
+	uint64_t _read_only_arguments = 0; // Bit `i` is set if argument `i` is never written, so it can be borrowed from the caller.
 	int _stack_size = 0;
 	int _instruction_args_size = 0;
 
 	SelfList<RuztaFunction> function_list{ this };
 	mutable Variant nil;
-	HashMap<int, Variant::Type> temporary_slots;
+	// Typed temporaries, in stack order, and the type each call initializes them to.
+	struct TemporarySlot {
+		int stack_index = 0;
+		Variant::Type type = Variant::NIL;
+	};
+	Vector<TemporarySlot> temporary_slots;
+	// Stack slots that may hold a value needing destruction, the others only ever hold trivial types.
+	Vector<int> nontrivial_slots;
 	List<StackDebug> stack_debug;
+	Vector<LineEntry> lines; // Sorted by `ip`, looked up only when a line is actually needed.
+
+	// Runtime state of a generic OPERATOR, GET/SET_KEYED or GET/SET_NAMED site. It's kept out of line,
+	// so the code stream only holds its index rather than the counters and a validated function pointer.
+	struct SiteCache {
+		typedef void (*Function)();
+
+		int signature = 0; // Operand types the function was resolved for, 0 until the first run.
+		int return_type = 0; // Result type of operators.
+		int counter = 0; // Quickening counter.
+		Function function = nullptr; // Validated evaluator, getter or setter, cast back by the instruction.
+	};
+
+	// Inline cache of a GET_NAMED/SET_NAMED site for bases that are Ruzta instances.
+	// Entries are only ever added, a site that sees more layouts stays generic.
+	struct MemberCache {
+		static constexpr int ENTRY_MAX = 4;
+
+		struct Entry {
+			// `Ruzta::member_layout_id` of the receiver's script. Stored last with release semantics,
+			// so a reader that acquires a matching id also sees the rest of the entry.
+			std::atomic<uint32_t> layout_id = 0;
+			int index = -1;
+			Variant::Type type = Variant::VARIANT_MAX; // Member type for assignments, VARIANT_MAX if untyped.
+
+			Entry() {}
+			Entry(const Entry &p_entry) { *this = p_entry; }
+			Entry &operator=(const Entry &p_entry) {
+				index = p_entry.index;
+				type = p_entry.type;
+				layout_id.store(p_entry.layout_id.load(std::memory_order_acquire), std::memory_order_release);
+				return *this;
+			}
+		};
+
+		Entry entries[ENTRY_MAX];
+		bool megamorphic = false;
+	};
+
+	// Inline cache of a CALL site for receivers that are Ruzta instances, or native objects without a script.
+	struct CallCache {
+		static constexpr int ENTRY_MAX = 4;
+
+		struct Entry {
+			std::atomic<uint32_t> layout_id = 0; // Published like `MemberCache::Entry::layout_id`.
+			RuztaFunction *function = nullptr; // nullptr if the method isn't a script function.
+
+			Entry() {}
+			Entry(const Entry &p_entry) { *this = p_entry; }
+			Entry &operator=(const Entry &p_entry) {
+				function = p_entry.function;
+				layout_id.store(p_entry.layout_id.load(std::memory_order_acquire), std::memory_order_release);
+				return *this;
+			}
+		};
+
+		// Written once under the lock before `native_count` publishes it, so readers can compare the class unlocked.
+		struct NativeEntry {
+			StringName native_class;
+			MethodBind *method = nullptr; // nullptr if the class doesn't bind the method.
+		};
+
+		Entry entries[ENTRY_MAX];
+		bool megamorphic = false;
+		NativeEntry native_entries[ENTRY_MAX];
+		std::atomic<int> native_count = 0;
+		bool native_megamorphic = false;
+
+		CallCache() {}
+		CallCache(const CallCache &p_cache) { *this = p_cache; }
+		CallCache &operator=(const CallCache &p_cache) {
+			for (int i = 0; i < ENTRY_MAX; i++) {
+				entries[i] = p_cache.entries[i];
+				native_entries[i] = p_cache.native_entries[i];
+			}
+			megamorphic = p_cache.megamorphic;
+			native_megamorphic = p_cache.native_megamorphic;
+			native_count.store(p_cache.native_count.load(std::memory_order_acquire), std::memory_order_release);
+			return *this;
+		}
+	};
+
+	// Target of a CALL_DIRECT site, a function that can't be overridden. Defined in "ruzta.h" since it holds a `Ruzta::UpdatableFuncPtr`.
+	struct DirectCall;
 
 	Vector<int> code;
+	Vector<uint16_t> compact_code; // Replaces `code` when the function can be encoded compactly.
 	Vector<int> default_arguments;
 	Vector<Variant> constants;
 	Vector<StringName> global_names;
@@ -496,6 +691,10 @@ private:
 	Vector<RuztaUtilityFunctions::FunctionPtr> gds_utilities;
 	Vector<MethodBind *> methods;
 	Vector<RuztaFunction *> lambdas;
+	Vector<SiteCache> site_caches;
+	Vector<MemberCache> member_caches;
+	Vector<CallCache> call_caches;
+	Vector<StringName> direct_call_names; // Resolved into `_direct_calls_ptr` once the whole script is compiled.
 
 	int _code_size = 0;
 	int _default_arg_count = 0;
@@ -514,8 +713,15 @@ private:
 	int _gds_utilities_count = 0;
 	int _methods_count = 0;
 	int _lambdas_count = 0;
+	int _site_caches_count = 0;
+	int _member_caches_count = 0;
+	int _call_caches_count = 0;
+	int _direct_calls_count = 0;
+	int _temporary_slots_count = 0;
+	int _nontrivial_slots_count = 0;
 
 	int *_code_ptr = nullptr;
+	uint16_t *_compact_code_ptr = nullptr;
 	const int *_default_arg_ptr = nullptr;
 	mutable Variant *_constants_ptr = nullptr;
 	const StringName *_global_names_ptr = nullptr;
@@ -532,6 +738,33 @@ private:
 	const RuztaUtilityFunctions::FunctionPtr *_gds_utilities_ptr = nullptr;
 	MethodBind **_methods_ptr = nullptr;
 	RuztaFunction **_lambdas_ptr = nullptr;
+	SiteCache *_site_caches_ptr = nullptr;
+	MemberCache *_member_caches_ptr = nullptr;
+	CallCache *_call_caches_ptr = nullptr;
+	DirectCall *_direct_calls_ptr = nullptr;
+	const TemporarySlot *_temporary_slots_ptr = nullptr;
+	const int *_nontrivial_slots_ptr = nullptr;
+	// Lowered form of the code run by the threaded loop, one entry per code position, built once the function
+	// is hot and published with release semantics. Opcode positions hold their handler address, patched along
+	// with the code when instructions rewrite themselves. Operand positions are resolved the first time they are
+	// read: stack addresses to a frame-relative byte offset tagged with the low bit, constants to a pointer into
+	// the constant pool. Member addresses depend on the instance and are always decoded from the code.
+	struct ThreadedOp {
+		std::atomic<const void *> handler = nullptr;
+		std::atomic<uintptr_t> operand = 0;
+	};
+	std::atomic<ThreadedOp *> _threaded_code_ptr = nullptr;
+	_FORCE_INLINE_ static bool _load_threaded_operand(const ThreadedOp &p_op, Variant *p_stack, Variant *&r_v) {
+		uintptr_t operand = p_op.operand.load(std::memory_order_relaxed);
+		if (operand & 1) {
+			r_v = (Variant *)((uint8_t *)p_stack + (operand >> 1));
+			return true;
+		}
+		r_v = (Variant *)operand;
+		return operand != 0;
+	}
+	std::atomic<uint32_t> _threaded_call_count = 0;
+	static const void *const *_threaded_handlers; // Handler per opcode in the threaded instantiation of `_call()`.
 
 #ifdef DEBUG_ENABLED
 	CharString func_cname;
@@ -545,14 +778,39 @@ private:
 	Vector<String> utilities_names;
 	Vector<String> gds_utilities_names;
 
+	// Code as emitted by the generator, kept only if the bytecode optimizer changed it.
+	Vector<int> unoptimized_code;
+
 	struct Profile {
+		// Counted by each calling thread on its own, summed up lazily under the language lock.
+		struct ThreadCounts {
+			// Written by the counting thread only, so adding needs no read-modify-write.
+			std::atomic<uint64_t> call_count = 0;
+			std::atomic<uint64_t> self_time = 0;
+			std::atomic<uint64_t> total_time = 0;
+			// Counts already summed up, written by the merging thread only.
+			uint64_t merged_call_count = 0;
+			uint64_t merged_self_time = 0;
+			uint64_t merged_total_time = 0;
+			// Held by the function and by the counting thread, whichever lets go last frees the counts.
+			std::atomic<uint32_t> owners = 2;
+
+			_FORCE_INLINE_ static void add(std::atomic<uint64_t> &r_counter, uint64_t p_value) {
+				r_counter.store(r_counter.load(std::memory_order_relaxed) + p_value, std::memory_order_relaxed);
+			}
+			static void release(ThreadCounts *p_counts);
+		};
+
+		uint64_t id = 0; // Unlike the function address, never reused.
+		LocalVector<ThreadCounts *> thread_counts;
+
 		StringName signature;
-		SafeNumeric<uint64_t> call_count;
-		SafeNumeric<uint64_t> self_time;
-		SafeNumeric<uint64_t> total_time;
-		SafeNumeric<uint64_t> frame_call_count;
-		SafeNumeric<uint64_t> frame_self_time;
-		SafeNumeric<uint64_t> frame_total_time;
+		uint64_t call_count = 0;
+		uint64_t self_time = 0;
+		uint64_t total_time = 0;
+		uint64_t frame_call_count = 0;
+		uint64_t frame_self_time = 0;
+		uint64_t frame_total_time = 0;
 		uint64_t last_frame_call_count = 0;
 		uint64_t last_frame_self_time = 0;
 		uint64_t last_frame_total_time = 0;
@@ -563,12 +821,55 @@ private:
 		} NativeProfile;
 		HashMap<String, NativeProfile> native_calls;
 		HashMap<String, NativeProfile> last_native_calls;
+
+		void merge_thread_counts();
 	} profile;
+
+	struct ProfileThreadCache;
+	// A plain pointer, so counting needs no thread-local initialization guard.
+	// Set by `_create_profile_thread_cache()` on the first counted call of each thread.
+	static inline thread_local ProfileThreadCache *_profile_thread_cache = nullptr;
+	static ProfileThreadCache *_create_profile_thread_cache();
+	Profile::ThreadCounts *_get_profile_thread_counts();
 #endif
 
 	String _get_call_error(const String &p_where, const Variant **p_argptrs, int p_argcount, const Variant &p_ret, const GDExtensionCallError &p_err) const;
 	String _get_callable_call_error(const String &p_where, const Callable &p_callable, const Variant **p_argptrs, int p_argcount, const Variant &p_ret, const GDExtensionCallError &p_err) const;
 	Variant _get_default_variant_for_data_type(const RuztaDataType &p_data_type);
+	const MemberCache::Entry *_get_member_cache_entry(MemberCache *p_cache, const RuztaInstance *p_instance, const StringName &p_name, bool p_assign);
+	RuztaFunction *_get_call_cache_function(CallCache *p_cache, const RuztaInstance *p_instance, const StringName &p_method);
+	MethodBind *_get_call_cache_method(CallCache *p_cache, Object *p_object, const StringName &p_method);
+
+	// Quickening rewrites opcodes while other threads may run the same code, so every access is a relaxed atomic one.
+	// Nothing else is published through the code, readers only need to see either the old or the new opcode.
+	static_assert(sizeof(std::atomic<int>) == sizeof(int) && std::atomic<int>::is_always_lock_free);
+	static_assert(sizeof(std::atomic<uint16_t>) == sizeof(uint16_t) && std::atomic<uint16_t>::is_always_lock_free);
+
+	template <bool t_compact>
+	_FORCE_INLINE_ int _read_code(int p_pos) const {
+		if constexpr (t_compact) {
+			return decode_compact_unit(reinterpret_cast<const std::atomic<uint16_t> *>(&_compact_code_ptr[p_pos])->load(std::memory_order_relaxed));
+		} else {
+			return reinterpret_cast<const std::atomic<int> *>(&_code_ptr[p_pos])->load(std::memory_order_relaxed);
+		}
+	}
+	template <bool t_compact>
+	_FORCE_INLINE_ void _write_opcode(int p_pos, int p_opcode) {
+		if constexpr (t_compact) {
+			reinterpret_cast<std::atomic<uint16_t> *>(&_compact_code_ptr[p_pos])->store((uint16_t)p_opcode, std::memory_order_relaxed);
+		} else {
+			reinterpret_cast<std::atomic<int> *>(&_code_ptr[p_pos])->store(p_opcode, std::memory_order_relaxed);
+		}
+	}
+
+	template <bool t_threaded, bool t_compact>
+	Variant _call(RuztaInstance *p_instance, const Variant **p_args, int p_argcount, GDExtensionCallError &r_err, CallState *p_state, bool p_validated_args, uint64_t p_stable_args);
+	void _resolve_direct_calls();
+	void _clear_direct_calls();
+#ifdef DEBUG_ENABLED
+	void _disassemble_code(const int *p_code, int p_code_size, const Vector<String> &p_code_lines, Vector<String> &r_lines) const;
+	Vector<int> _get_disassembly_code() const;
+#endif
 
 public:
 	static constexpr int MAX_CALL_DEPTH = 2048; // Limit to try to avoid crash because of a stack overflow.
@@ -587,12 +888,17 @@ public:
 		int line = 0;
 		int defarg = 0;
 		Variant result;
+		RuztaFunctionState *generator = nullptr; // Set when the frame belongs to a generator, which keeps this state across `yield`s.
+		bool yielded = false;
 	};
 
 	_FORCE_INLINE_ StringName get_name() const { return name; }
 	_FORCE_INLINE_ StringName get_source() const { return source; }
 	_FORCE_INLINE_ Ruzta *get_script() const { return _script; }
 	_FORCE_INLINE_ bool is_static() const { return _static; }
+	_FORCE_INLINE_ bool is_generator() const { return _generator; }
+	_FORCE_INLINE_ bool has_line_opcodes() const { return _line_opcodes; }
+	_FORCE_INLINE_ bool has_compact_code() const { return _compact_code_ptr != nullptr; }
 	_FORCE_INLINE_ bool is_vararg() const { return _vararg_index >= 0; }
 	_FORCE_INLINE_ MethodInfo get_method_info() const { return method_info; }
 	_FORCE_INLINE_ int get_argument_count() const { return _argument_count; }
@@ -602,18 +908,74 @@ public:
 	Variant get_constant(int p_idx) const;
 	StringName get_global_name(int p_idx) const;
 
-	Variant call(RuztaInstance *p_instance, const Variant **p_args, int p_argcount, GDExtensionCallError &r_err, CallState *p_state = nullptr);
+	// `p_validated_args` skips the argument type checks, for callers that have already proven the types exactly match.
+	// Bit `i` of `p_stable_args` tells argument `i` stays alive and unchanged until the call returns, so it can be borrowed instead of copied.
+	Variant call(RuztaInstance *p_instance, const Variant **p_args, int p_argcount, GDExtensionCallError &r_err, CallState *p_state = nullptr, bool p_validated_args = false, uint64_t p_stable_args = 0);
 	void debug_get_stack_member_state(int p_line, List<Pair<StringName, int>> *r_stackvars) const;
+	int get_line(int p_ip) const;
 
 #ifdef DEBUG_ENABLED
 	void _profile_native_call(uint64_t p_t_taken, const String &p_function_name, const String &p_instance_class_name = String());
 	void disassemble(const Vector<String> &p_code_lines) const;
+	void disassemble_optimizer_diff(const Vector<String> &p_code_lines) const;
+	PackedStringArray get_disassembly() const;
 #endif
 
 	RuztaFunction();
 	~RuztaFunction();
 };
 
+#ifdef RUZTA_OPCODE_STATS
+// Opcode and opcode pair execution counts, only built with `opcode_stats=yes`.
+// Each thread counts into its own buffer, reports merge all of them.
+struct RuztaOpcodeStats {
+	static constexpr int OPCODE_COUNT = RuztaFunction::OPCODE_END + 1;
+
+	struct FunctionCounts {
+		String name;
+		uint64_t opcodes[OPCODE_COUNT] = {};
+		HashMap<uint32_t, uint64_t> pairs; // Key is `previous * OPCODE_COUNT + opcode`.
+
+		void add_pair(uint32_t p_pair);
+	};
+
+	// Lives on the stack of `RuztaFunction::call()`, pairs don't cross calls.
+	struct Recorder {
+		RuztaOpcodeStats *stats = nullptr;
+		FunctionCounts *function = nullptr;
+		int previous = -1;
+
+		_FORCE_INLINE_ void record(int p_opcode) {
+			stats->opcodes[p_opcode]++;
+			function->opcodes[p_opcode]++;
+			if (previous >= 0) {
+				const uint32_t pair = previous * OPCODE_COUNT + p_opcode;
+				stats->pairs[pair]++;
+				uint64_t *count = function->pairs.getptr(pair);
+				if (likely(count != nullptr)) {
+					(*count)++;
+				} else {
+					function->add_pair(pair);
+				}
+			}
+			previous = p_opcode;
+		}
+
+		Recorder(const RuztaFunction *p_function);
+	};
+
+	uint64_t opcodes[OPCODE_COUNT] = {};
+	uint64_t pairs[OPCODE_COUNT * OPCODE_COUNT] = {};
+	HashMap<const RuztaFunction *, FunctionCounts *> functions;
+
+	static const char *get_opcode_name(int p_opcode);
+	static Dictionary get_report();
+	static void reset();
+
+	~RuztaOpcodeStats();
+};
+#endif // RUZTA_OPCODE_STATS
+
 class RuztaFunctionState : public RefCounted {
 	GDCLASS(RuztaFunctionState, RefCounted);
 	friend class RuztaFunction;
@@ -625,6 +987,12 @@ class RuztaFunctionState : public RefCounted {
 	SelfList<RuztaFunctionState> scripts_list;
 	SelfList<RuztaFunctionState> instances_list;
 
+	Variant yielded_value; // Last value of a generator, for `_iter_get()`.
+
+	bool _iter_init(const Variant &p_iter);
+	bool _iter_next(const Variant &p_iter);
+	Variant _iter_get(const Variant &p_iter) const;
+
 protected:
 	static void _bind_methods();
 
@@ -632,6 +1000,11 @@ public:
 	bool is_valid(bool p_extended_check = false) const;
 	Variant resume(const Variant &p_arg = Variant());
 
+	_FORCE_INLINE_ bool is_generator() const { return state.generator != nullptr; }
+	// Runs a generator up to its next `yield`, whose value goes to `r_value`.
+	// Returns false once the generator has finished.
+	bool resume_generator(Variant &r_value, const Variant &p_arg = Variant());
+
 #ifdef DEBUG_ENABLED
 	// Returns a human-readable representation of the function.
 	String get_readable_function() {
@@ -199,6 +199,9 @@ RuztaParser::RuztaParser() {
 		register_annotation(MethodInfo("@warning_ignore", PropertyInfo(Variant::STRING, "warning")), AnnotationInfo::CLASS_LEVEL | AnnotationInfo::STATEMENT, &RuztaParser::warning_ignore_annotation, varray(), true);
 		register_annotation(MethodInfo("@warning_ignore_start", PropertyInfo(Variant::STRING, "warning")), AnnotationInfo::STANDALONE, &RuztaParser::warning_ignore_region_annotations, varray(), true);
 		register_annotation(MethodInfo("@warning_ignore_restore", PropertyInfo(Variant::STRING, "warning")), AnnotationInfo::STANDALONE, &RuztaParser::warning_ignore_region_annotations, varray(), true);
+		// Optimization.
+		register_annotation(MethodInfo("@inline"), AnnotationInfo::FUNCTION, &RuztaParser::inline_annotation);
+		register_annotation(MethodInfo("@final"), AnnotationInfo::SCRIPT | AnnotationInfo::CLASS | AnnotationInfo::FUNCTION, &RuztaParser::final_annotation);
 		// Networking.
 		register_annotation(MethodInfo("@rpc", PropertyInfo(Variant::STRING, "mode"), PropertyInfo(Variant::STRING, "sync"), PropertyInfo(Variant::STRING, "transfer_mode"), PropertyInfo(Variant::INT, "transfer_channel")), AnnotationInfo::FUNCTION, &RuztaParser::rpc_annotation, varray("authority", "call_remote", "unreliable", 0));
 	}
@@ -2148,6 +2151,7 @@ RuztaParser::Node *RuztaParser::parse_statement() {
 					case Node::ASSIGNMENT:
 					case Node::AWAIT:
 					case Node::CALL:
+					case Node::YIELD:
 						// Fine.
 						break;
 					case Node::PRELOAD:
@@ -3231,6 +3235,9 @@ RuztaParser::ExpressionNode *RuztaParser::parse_await(ExpressionNode *p_previous
 	complete_extents(await);
 
 	if (current_function) { // Might be null in a getter or setter.
+		if (current_function->is_generator) {
+			push_error(R"(Cannot use "await" in a function that uses "yield".)", await);
+		}
 		current_function->is_coroutine = true;
 	}
 
@@ -3828,8 +3835,24 @@ RuztaParser::ExpressionNode *RuztaParser::parse_type_test(ExpressionNode *p_prev
 }
 
 RuztaParser::ExpressionNode *RuztaParser::parse_yield(ExpressionNode *p_previous_operand, bool p_can_assign) {
-	push_error(R"("yield" was removed in Godot 4. Use "await" instead.)");
-	return nullptr;
+	YieldNode *yield = alloc_node<YieldNode>();
+	if (!is_statement_end_token() && !check(RuztaTokenizer::Token::PARENTHESIS_CLOSE)) {
+		yield->value = parse_expression(false);
+		if (yield->value == nullptr) {
+			push_error(R"(Expected expression after "yield".)");
+		}
+	}
+	complete_extents(yield);
+
+	if (current_function == nullptr) {
+		push_error(R"("yield" can only be used inside a function.)", yield);
+	} else if (current_function->is_coroutine) {
+		push_error(R"(Cannot use "yield" in a function that uses "await".)", yield);
+	} else {
+		current_function->is_generator = true;
+	}
+
+	return yield;
 }
 
 RuztaParser::ExpressionNode *RuztaParser::parse_invalid_token(ExpressionNode *p_previous_operand, bool p_can_assign) {
@@ -4493,6 +4516,53 @@ bool RuztaParser::abstract_annotation(AnnotationNode *p_annotation, Node *p_targ
 	ERR_FAIL_V_MSG(false, R"("@abstract" annotation can only be applied to classes and functions.)");
 }
 
+bool RuztaParser::inline_annotation(AnnotationNode *p_annotation, Node *p_target, ClassNode *p_class) {
+	ERR_FAIL_COND_V_MSG(p_target->type != Node::FUNCTION, false, R"("@inline" annotation can only be applied to functions.)");
+
+	FunctionNode *function_node = static_cast<FunctionNode *>(p_target);
+	if (function_node->is_abstract) {
+		push_error(R"("@inline" annotation cannot be applied to abstract functions.)", p_annotation);
+		return false;
+	}
+	if (function_node->is_inline) {
+		push_error(R"("@inline" annotation can only be used once per function.)", p_annotation);
+		return false;
+	}
+	function_node->is_inline = true;
+	return true;
+}
+
+bool RuztaParser::final_annotation(AnnotationNode *p_annotation, Node *p_target, ClassNode *p_class) {
+	// NOTE: Use `p_target`, **not** `p_class`, because when `p_target` is a class then `p_class` refers to the outer class.
+	if (p_target->type == Node::CLASS) {
+		ClassNode *class_node = static_cast<ClassNode *>(p_target);
+		if (class_node->is_abstract) {
+			push_error(R"("@final" annotation cannot be applied to abstract classes.)", p_annotation);
+			return false;
+		}
+		if (class_node->is_final) {
+			push_error(R"("@final" annotation can only be used once per class.)", p_annotation);
+			return false;
+		}
+		class_node->is_final = true;
+		return true;
+	}
+	if (p_target->type == Node::FUNCTION) {
+		FunctionNode *function_node = static_cast<FunctionNode *>(p_target);
+		if (function_node->is_abstract) {
+			push_error(R"("@final" annotation cannot be applied to abstract functions.)", p_annotation);
+			return false;
+		}
+		if (function_node->is_final) {
+			push_error(R"("@final" annotation can only be used once per function.)", p_annotation);
+			return false;
+		}
+		function_node->is_final = true;
+		return true;
+	}
+	ERR_FAIL_V_MSG(false, R"("@final" annotation can only be applied to classes and functions.)");
+}
+
 bool RuztaParser::onready_annotation(AnnotationNode *p_annotation, Node *p_target, ClassNode *p_class) {
 	ERR_FAIL_COND_V_MSG(p_target->type != Node::VARIABLE, false, R"("@onready" annotation can only be applied to class variables.)");
 
@@ -6018,6 +6088,9 @@ void RuztaParser::TreePrinter::print_expression(ExpressionNode *p_expression) {
 		case Node::UNARY_OPERATOR:
 			print_unary_op(static_cast<UnaryOpNode *>(p_expression));
 			break;
+		case Node::YIELD:
+			print_yield(static_cast<YieldNode *>(p_expression));
+			break;
 		default:
 			push_text(vformat("<unknown expression %d>", p_expression->type));
 			break;
@@ -6488,6 +6561,14 @@ void RuztaParser::TreePrinter::print_while(WhileNode *p_while) {
 	decrease_indent();
 }
 
+void RuztaParser::TreePrinter::print_yield(YieldNode *p_yield) {
+	push_text("Yield");
+	if (p_yield->value) {
+		push_text(" ");
+		print_expression(p_yield->value);
+	}
+}
+
 void RuztaParser::TreePrinter::print_tree(const RuztaParser &p_parser) {
 	ClassNode *class_tree = p_parser.get_tree();
 	ERR_FAIL_NULL_MSG(class_tree, "Parse the code before printing the parse tree.");
@@ -101,6 +101,7 @@ public:
 	struct UnaryOpNode;
 	struct VariableNode;
 	struct WhileNode;
+	struct YieldNode;
 
 	class DataType {
 	public:
@@ -338,6 +339,7 @@ public:
 			UNARY_OPERATOR,
 			VARIABLE,
 			WHILE,
+			YIELD,
 		};
 
 		Type type = NONE;
@@ -752,6 +754,7 @@ public:
 		bool extends_used = false;
 		bool onready_used = false;
 		bool is_abstract = false;
+		bool is_final = false;
 		bool has_static_data = false;
 		bool annotated_static_unload = false;
 		String extends_path;
@@ -861,6 +864,9 @@ public:
 		bool is_abstract = false;
 		bool is_static = false; // For lambdas it's determined in the analyzer.
 		bool is_coroutine = false;
+		bool is_generator = false;
+		bool is_inline = false;
+		bool is_final = false;
 		Variant rpc_config;
 		MethodInfo info;
 		LambdaNode *source_lambda = nullptr;
@@ -874,6 +880,10 @@ public:
 		bool resolved_signature = false;
 		bool resolved_body = false;
 
+		// Common type of all `return` statements, used when the return type isn't specified.
+		DataType inferred_return_type;
+		bool inferred_return_conflict = false;
+
 		_FORCE_INLINE_ bool is_vararg() const { return rest_parameter != nullptr; }
 
 		FunctionNode() {
@@ -987,6 +997,8 @@ public:
 	};
 
 	struct ParameterNode : public AssignableNode {
+		bool is_written = false; // Assigned to, directly or through a subscript, so the function needs its own copy.
+
 		ParameterNode() {
 			type = PARAMETER;
 		}
@@ -1266,6 +1278,7 @@ public:
 		bool onready = false;
 		PropertyInfo export_info;
 		int assignments = 0;
+		bool inferred_type_conflict = false; // Set by the analyzer when an assignment changes the inferred type of a local.
 		bool is_static = false;
 #ifdef TOOLS_ENABLED
 		MemberDocData doc_data;
@@ -1285,6 +1298,14 @@ public:
 		}
 	};
 
+	struct YieldNode : public ExpressionNode {
+		ExpressionNode *value = nullptr;
+
+		YieldNode() {
+			type = YIELD;
+		}
+	};
+
 	enum CompletionType {
 		COMPLETION_NONE,
 		COMPLETION_ANNOTATION, // Annotation (following @).
@@ -1553,6 +1574,8 @@ private:
 	bool icon_annotation(AnnotationNode *p_annotation, Node *p_target, ClassNode *p_class);
 	bool static_unload_annotation(AnnotationNode *p_annotation, Node *p_target, ClassNode *p_class);
 	bool abstract_annotation(AnnotationNode *p_annotation, Node *p_target, ClassNode *p_class);
+	bool inline_annotation(AnnotationNode *p_annotation, Node *p_target, ClassNode *p_class);
+	bool final_annotation(AnnotationNode *p_annotation, Node *p_target, ClassNode *p_class);
 	bool onready_annotation(AnnotationNode *p_annotation, Node *p_target, ClassNode *p_class);
 	template <PropertyHint t_hint, Variant::Type t_type>
 	bool export_annotations(AnnotationNode *p_annotation, Node *p_target, ClassNode *p_class);
@@ -1705,6 +1728,7 @@ public:
 		void print_unary_op(UnaryOpNode *p_unary_op);
 		void print_variable(VariableNode *p_variable);
 		void print_while(WhileNode *p_while);
+		void print_yield(YieldNode *p_yield);
 
 	public:
 		void print_tree(const RuztaParser &p_parser);
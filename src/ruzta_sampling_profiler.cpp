@@ -0,0 +1,190 @@
+/**************************************************************************/
+/*  ruzta_sampling_profiler.cpp                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                RUZTA                                   */
+/*                    https://seremtitus.co.ke/ruzta                      */
+/**************************************************************************/
+//* Copyright (c) 2025-present Ruzta contributors (see AUTHORS.md).        */
+/* Copyright (c) 2014-present Godot Engine contributors                   */
+/*                                             (see OG_AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "ruzta_sampling_profiler.h"
+
+#include <godot_cpp/classes/os.hpp> // original: core/os/os.h
+#include <godot_cpp/core/mutex_lock.hpp> // original:
+
+RuztaSamplingProfiler::Node::~Node() {
+	for (const KeyValue<String, Node *> &E : children) {
+		memdelete(E.value);
+	}
+}
+
+// Called with the language lock held, functions on the stack can't go away until it returns.
+// Only copies what the sample needs, the tree is updated once the lock is released.
+void RuztaSamplingProfiler::_copy_sample(const RuztaLanguage::CallStack &p_stack, void *p_userdata) {
+	LocalVector<Sample> *samples = (LocalVector<Sample> *)p_userdata;
+
+	const uint32_t size = p_stack.size.load(std::memory_order_acquire); // Read once, the owning thread keeps running.
+	if (size == 0) {
+		return;
+	}
+
+	samples->push_back(Sample());
+	Sample &sample = (*samples)[samples->size() - 1];
+	for (uint32_t i = size - MIN(size, RuztaLanguage::CALL_STACK_RING_SIZE); i < size; i++) {
+		const RuztaLanguage::CallLevel &level = p_stack.levels[i & RuztaLanguage::CALL_STACK_RING_MASK];
+		const RuztaFunction *function = level.function;
+		if (unlikely(function == nullptr)) {
+			break; // Level being entered.
+		}
+
+		Frame frame;
+		frame.source = function->get_source();
+		frame.function = function->get_name();
+		frame.line = level.get_line();
+		sample.push_back(frame);
+	}
+}
+
+void RuztaSamplingProfiler::_add_sample(const Sample &p_sample) {
+	Node *node = &root;
+	node->samples++;
+	for (const Frame &frame : p_sample) {
+		const String name = String(frame.source) + "::" + String(frame.function);
+		Node **child = node->children.getptr(name);
+		if (child == nullptr) {
+			Node *new_child = memnew(Node);
+			new_child->name = name;
+			child = &node->children.insert(name, new_child)->value;
+		}
+		node = *child;
+		node->samples++;
+		node->lines[frame.line]++;
+	}
+	node->self_samples++;
+}
+
+void RuztaSamplingProfiler::_thread_func(void *p_userdata) {
+	RuztaSamplingProfiler *profiler = (RuztaSamplingProfiler *)p_userdata;
+
+	LocalVector<Sample> samples;
+	while (profiler->running.is_set()) {
+		OS::get_singleton()->delay_usec(profiler->interval_usec);
+
+		samples.clear();
+		RuztaLanguage::get_singleton()->_for_each_call_stack(_copy_sample, &samples);
+
+		MutexLock lock(profiler->mutex);
+		for (const Sample &sample : samples) {
+			profiler->_add_sample(sample);
+		}
+	}
+}
+
+Error RuztaSamplingProfiler::start(uint64_t p_interval_usec) {
+	ERR_FAIL_COND_V_MSG(running.is_set(), ERR_ALREADY_IN_USE, "The sampling profiler is already running.");
+	ERR_FAIL_COND_V(p_interval_usec == 0, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V_MSG(!RuztaLanguage::get_singleton()->should_track_call_stack(), ERR_UNCONFIGURED, R"(Sampling reads the tracked call stacks, enable "debug/settings/ruzta/always_track_call_stacks" to use it in release builds.)");
+
+	interval_usec = p_interval_usec;
+	running.set();
+	thread.start(_thread_func, this);
+	return OK;
+}
+
+void RuztaSamplingProfiler::stop() {
+	if (!running.is_set()) {
+		return;
+	}
+	running.clear();
+	thread.wait_to_finish();
+}
+
+Dictionary RuztaSamplingProfiler::_get_node_report(const Node *p_node) {
+	Dictionary lines;
+	for (const KeyValue<int, uint64_t> &E : p_node->lines) {
+		lines[E.key] = E.value;
+	}
+	Array children;
+	for (const KeyValue<String, Node *> &E : p_node->children) {
+		children.push_back(_get_node_report(E.value));
+	}
+
+	Dictionary report;
+	report["function"] = p_node->name;
+	report["samples"] = p_node->samples;
+	report["self_samples"] = p_node->self_samples;
+	report["lines"] = lines;
+	report["children"] = children;
+	return report;
+}
+
+Dictionary RuztaSamplingProfiler::get_report() {
+	MutexLock lock(mutex);
+
+	Array functions;
+	for (const KeyValue<String, Node *> &E : root.children) {
+		functions.push_back(_get_node_report(E.value));
+	}
+
+	Dictionary report;
+	report["samples"] = root.samples;
+	report["interval_usec"] = interval_usec;
+	report["functions"] = functions;
+	return report;
+}
+
+void RuztaSamplingProfiler::_add_collapsed_stacks(const Node *p_node, const String &p_prefix, String &r_collapsed) {
+	for (const KeyValue<String, Node *> &E : p_node->children) {
+		const String stack = p_prefix.is_empty() ? E.value->name : p_prefix + ";" + E.value->name;
+		if (E.value->self_samples > 0) {
+			r_collapsed += stack + " " + itos(E.value->self_samples) + "\n";
+		}
+		_add_collapsed_stacks(E.value, stack, r_collapsed);
+	}
+}
+
+String RuztaSamplingProfiler::get_collapsed_stacks() {
+	MutexLock lock(mutex);
+
+	String collapsed;
+	_add_collapsed_stacks(&root, String(), collapsed);
+	return collapsed;
+}
+
+void RuztaSamplingProfiler::reset() {
+	MutexLock lock(mutex);
+
+	for (const KeyValue<String, Node *> &E : root.children) {
+		memdelete(E.value);
+	}
+	root.children.clear();
+	root.samples = 0;
+	root.self_samples = 0;
+}
+
+RuztaSamplingProfiler::~RuztaSamplingProfiler() {
+	stop();
+}
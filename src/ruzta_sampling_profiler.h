@@ -0,0 +1,94 @@
+/**************************************************************************/
+/*  ruzta_sampling_profiler.h                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                RUZTA                                   */
+/*                    https://seremtitus.co.ke/ruzta                      */
+/**************************************************************************/
+//* Copyright (c) 2025-present Ruzta contributors (see AUTHORS.md).        */
+/* Copyright (c) 2014-present Godot Engine contributors                   */
+/*                                             (see OG_AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "ruzta.h"
+
+#include <godot_cpp/classes/mutex.hpp> // original: core/os/mutex.h
+#include <godot_cpp/classes/thread.hpp> // original: core/os/thread.h
+#include <godot_cpp/templates/hash_map.hpp> // original: core/templates/hash_map.h
+#include <godot_cpp/templates/local_vector.hpp> // original: core/templates/local_vector.h
+#include <godot_cpp/templates/safe_refcount.hpp> // original: core/templates/safe_refcount.h
+
+using namespace godot;
+
+// Periodically snapshots the call stack of every thread running script code from
+// a thread of its own, and adds the samples up into a call tree. Running functions
+// pay nothing for it beyond the call stack tracking they already do.
+class RuztaSamplingProfiler {
+	// What a sample keeps of a call level. Copied while the language lock keeps the
+	// functions alive, the tree never points at a function, whose address may be reused.
+	struct Frame {
+		StringName source;
+		StringName function;
+		int line = 0;
+	};
+	typedef LocalVector<Frame> Sample; // Outermost level first.
+
+	struct Node {
+		String name;
+		uint64_t samples = 0; // Samples with this node anywhere on the stack.
+		uint64_t self_samples = 0; // Samples with this node on top of the stack.
+		HashMap<int, uint64_t> lines;
+		HashMap<String, Node *> children;
+
+		~Node();
+	};
+
+	Node root; // Its sample count is the number of stacks sampled.
+
+	Mutex mutex;
+	Thread thread;
+	SafeFlag running;
+	uint64_t interval_usec = 0;
+
+	static void _copy_sample(const RuztaLanguage::CallStack &p_stack, void *p_userdata);
+	void _add_sample(const Sample &p_sample);
+	static void _thread_func(void *p_userdata);
+
+	static Dictionary _get_node_report(const Node *p_node);
+	static void _add_collapsed_stacks(const Node *p_node, const String &p_prefix, String &r_collapsed);
+
+public:
+	Error start(uint64_t p_interval_usec);
+	void stop();
+	bool is_running() const { return running.is_set(); }
+
+	// Call tree with the sample counts of every function and of its lines.
+	Dictionary get_report();
+	// One line per stack, `outermost;...;innermost <count>`, as read by flame graph tools.
+	String get_collapsed_stacks();
+	void reset();
+
+	~RuztaSamplingProfiler();
+};
@@ -31,12 +31,14 @@
 /**************************************************************************/
 
 #include "ruzta.h"
+#include "ruzta_await_scheduler.h"
 #include "ruzta_function.h"
 #include "ruzta_lambda_callable.h"
 
 #include <godot_cpp/classes/os.hpp> // original: core/os/os.h
 #include <godot_cpp/variant/variant_internal.hpp> // original:
 #include <godot_cpp/core/mutex_lock.hpp> // original:
+#include <godot_cpp/templates/local_vector.hpp> // original: core/templates/local_vector.h
 
 #ifdef DEBUG_ENABLED
 
@@ -251,11 +253,135 @@ void (*type_init_function_table[])(Variant *) = {
 	&VariantDefaultInitializer<PackedVector4Array, Variant::PACKED_VECTOR4_ARRAY>::init, // PACKED_VECTOR4_ARRAY.
 };
 
+// Per-thread stack of VM frames. Calls release their frames in reverse order,
+// so taking one is a pointer bump and frames don't live on the native stack.
+// Chunks are kept once allocated and reused by later calls.
+class RuztaFrameArena {
+	static constexpr uint32_t CHUNK_SIZE = 64 * 1024;
+	static constexpr uint32_t ALIGNMENT = 16;
+
+	struct Chunk {
+		uint8_t *memory = nullptr;
+		uint32_t size = 0;
+	};
+
+	LocalVector<Chunk> chunks;
+	uint32_t current = 0; // Chunk frames are taken from.
+	uint32_t offset = 0; // Bytes used in the current chunk.
+
+	uint8_t *_alloc_in_next_chunk(uint32_t p_size) {
+		const uint32_t next = offset == 0 ? current : current + 1;
+		if (next == chunks.size()) {
+			chunks.push_back(Chunk());
+		} else if (chunks[next].size < p_size) {
+			// Unused since frames above `current` are released, swap it for one that fits.
+			memfree(chunks[next].memory);
+			chunks[next] = Chunk();
+		}
+		if (chunks[next].memory == nullptr) {
+			chunks[next].size = MAX(CHUNK_SIZE, p_size);
+			chunks[next].memory = (uint8_t *)memalloc(chunks[next].size);
+		}
+		current = next;
+		offset = p_size;
+		return chunks[next].memory;
+	}
+
+public:
+	struct Scope {
+		RuztaFrameArena &arena;
+		uint32_t chunk;
+		uint32_t offset;
+
+		Scope(RuztaFrameArena &p_arena) :
+				arena(p_arena), chunk(p_arena.current), offset(p_arena.offset) {}
+		~Scope() {
+			arena.current = chunk;
+			arena.offset = offset;
+		}
+	};
+
+	_FORCE_INLINE_ uint8_t *alloc(uint32_t p_size) {
+		p_size = (p_size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+		if (likely(current < chunks.size() && offset + p_size <= chunks[current].size)) {
+			uint8_t *frame = chunks[current].memory + offset;
+			offset += p_size;
+			return frame;
+		}
+		return _alloc_in_next_chunk(p_size);
+	}
+
+	~RuztaFrameArena() {
+		for (const Chunk &chunk : chunks) {
+			if (chunk.memory) {
+				memfree(chunk.memory);
+			}
+		}
+	}
+};
+
+static thread_local RuztaFrameArena frame_arena;
+
+#ifdef RUZTA_OPCODE_STATS
+#define RECORD_OPCODE(m_opcode) opcode_recorder.record(m_opcode);
+#else
+#define RECORD_OPCODE(m_opcode)
+#endif
+
+// `t_compact` is a template parameter of `RuztaFunction::_call()`, telling which form of the code it decodes.
+#define CODE(m_pos) _read_code<t_compact>(m_pos)
+#define STABLE_ARGUMENTS(m_pos, m_argc) (t_compact ? _get_stable_arguments(&_compact_code_ptr[m_pos], m_argc) : _get_stable_arguments(&_code_ptr[m_pos], m_argc))
+
 #if defined(__GNUC__) || defined(__clang__)
 #define OPCODES_TABLE                                    \
 	static const void *switch_table_ops[] = {            \
 		&&OPCODE_OPERATOR,                               \
 		&&OPCODE_OPERATOR_VALIDATED,                     \
+		&&OPCODE_OPERATOR_QUICKENED,                     \
+		&&OPCODE_OPERATOR_ADD_INT,                       \
+		&&OPCODE_OPERATOR_SUB_INT,                       \
+		&&OPCODE_OPERATOR_MUL_INT,                       \
+		&&OPCODE_OPERATOR_EQUAL_INT,                     \
+		&&OPCODE_OPERATOR_NOT_EQUAL_INT,                 \
+		&&OPCODE_OPERATOR_LESS_INT,                      \
+		&&OPCODE_OPERATOR_LESS_EQUAL_INT,                \
+		&&OPCODE_OPERATOR_GREATER_INT,                   \
+		&&OPCODE_OPERATOR_GREATER_EQUAL_INT,             \
+		&&OPCODE_OPERATOR_ADD_FLOAT,                     \
+		&&OPCODE_OPERATOR_SUB_FLOAT,                     \
+		&&OPCODE_OPERATOR_MUL_FLOAT,                     \
+		&&OPCODE_OPERATOR_DIV_FLOAT,                     \
+		&&OPCODE_OPERATOR_EQUAL_FLOAT,                   \
+		&&OPCODE_OPERATOR_NOT_EQUAL_FLOAT,               \
+		&&OPCODE_OPERATOR_LESS_FLOAT,                    \
+		&&OPCODE_OPERATOR_LESS_EQUAL_FLOAT,              \
+		&&OPCODE_OPERATOR_GREATER_FLOAT,                 \
+		&&OPCODE_OPERATOR_GREATER_EQUAL_FLOAT,           \
+		&&OPCODE_OPERATOR_ADD_VECTOR2,                   \
+		&&OPCODE_OPERATOR_SUB_VECTOR2,                   \
+		&&OPCODE_OPERATOR_MUL_VECTOR2,                   \
+		&&OPCODE_OPERATOR_MUL_VECTOR2_FLOAT,             \
+		&&OPCODE_OPERATOR_ADD_VECTOR3,                   \
+		&&OPCODE_OPERATOR_SUB_VECTOR3,                   \
+		&&OPCODE_OPERATOR_MUL_VECTOR3,                   \
+		&&OPCODE_OPERATOR_MUL_VECTOR3_FLOAT,             \
+		&&OPCODE_JUMP_IF_NOT_OPERATOR_VALIDATED,         \
+		&&OPCODE_JUMP_IF_NOT_EQUAL_INT,                  \
+		&&OPCODE_JUMP_IF_NOT_NOT_EQUAL_INT,              \
+		&&OPCODE_JUMP_IF_NOT_LESS_INT,                   \
+		&&OPCODE_JUMP_IF_NOT_LESS_EQUAL_INT,             \
+		&&OPCODE_JUMP_IF_NOT_GREATER_INT,                \
+		&&OPCODE_JUMP_IF_NOT_GREATER_EQUAL_INT,          \
+		&&OPCODE_JUMP_IF_NOT_EQUAL_FLOAT,                \
+		&&OPCODE_JUMP_IF_NOT_NOT_EQUAL_FLOAT,            \
+		&&OPCODE_JUMP_IF_NOT_LESS_FLOAT,                 \
+		&&OPCODE_JUMP_IF_NOT_LESS_EQUAL_FLOAT,           \
+		&&OPCODE_JUMP_IF_NOT_GREATER_FLOAT,              \
+		&&OPCODE_JUMP_IF_NOT_GREATER_EQUAL_FLOAT,        \
+		&&OPCODE_GET_MEMBER_CALL_VALIDATED_RETURN,       \
+		&&OPCODE_GET_MEMBER_CALL_VALIDATED_NO_RETURN,    \
+		&&OPCODE_ASSIGN_ITERATE_BEGIN,                   \
+		&&OPCODE_ASSIGN_ITERATE_BEGIN_ARRAY,             \
 		&&OPCODE_TYPE_TEST_BUILTIN,                      \
 		&&OPCODE_TYPE_TEST_ARRAY,                        \
 		&&OPCODE_TYPE_TEST_DICTIONARY,                   \
@@ -264,13 +390,17 @@ void (*type_init_function_table[])(Variant *) = {
 		&&OPCODE_SET_KEYED,                              \
 		&&OPCODE_SET_KEYED_VALIDATED,                    \
 		&&OPCODE_SET_INDEXED_VALIDATED,                  \
+		&&OPCODE_SET_KEYED_QUICKENED,                    \
 		&&OPCODE_GET_KEYED,                              \
 		&&OPCODE_GET_KEYED_VALIDATED,                    \
 		&&OPCODE_GET_INDEXED_VALIDATED,                  \
+		&&OPCODE_GET_KEYED_QUICKENED,                    \
 		&&OPCODE_SET_NAMED,                              \
 		&&OPCODE_SET_NAMED_VALIDATED,                    \
+		&&OPCODE_SET_NAMED_QUICKENED,                    \
 		&&OPCODE_GET_NAMED,                              \
 		&&OPCODE_GET_NAMED_VALIDATED,                    \
+		&&OPCODE_GET_NAMED_QUICKENED,                    \
 		&&OPCODE_SET_MEMBER,                             \
 		&&OPCODE_GET_MEMBER,                             \
 		&&OPCODE_SET_STATIC_VARIABLE,                    \
@@ -301,6 +431,8 @@ void (*type_init_function_table[])(Variant *) = {
 		&&OPCODE_CALL_RUZTA_UTILITY,                  \
 		&&OPCODE_CALL_BUILTIN_TYPE_VALIDATED,            \
 		&&OPCODE_CALL_SELF_BASE,                         \
+		&&OPCODE_CALL_DIRECT,                            \
+		&&OPCODE_CALL_DIRECT_VALIDATED,                  \
 		&&OPCODE_CALL_METHOD_BIND,                       \
 		&&OPCODE_CALL_METHOD_BIND_RET,                   \
 		&&OPCODE_CALL_BUILTIN_STATIC,                    \
@@ -311,6 +443,7 @@ void (*type_init_function_table[])(Variant *) = {
 		&&OPCODE_CALL_METHOD_BIND_VALIDATED_NO_RETURN,   \
 		&&OPCODE_AWAIT,                                  \
 		&&OPCODE_AWAIT_RESUME,                           \
+		&&OPCODE_YIELD,                                  \
 		&&OPCODE_CREATE_LAMBDA,                          \
 		&&OPCODE_CREATE_SELF_LAMBDA,                     \
 		&&OPCODE_JUMP,                                   \
@@ -422,16 +555,43 @@ void (*type_init_function_table[])(Variant *) = {
 	OPSEXIT:
 #define OPCODES_OUT \
 	OPSOUT:
-#define OPCODE_SWITCH(m_test) goto *switch_table_ops[m_test];
+// `t_threaded` is a template parameter of `RuztaFunction::_call()`, only one side of the choice is compiled.
+#define OPCODE_SWITCH(m_test) \
+	RECORD_OPCODE(m_test)     \
+	goto *(t_threaded ? threaded_ops[ip].handler.load(std::memory_order_relaxed) : switch_table_ops[m_test]);
 
 #ifdef DEBUG_ENABLED
-#define DISPATCH_OPCODE          \
-	last_opcode = _code_ptr[ip]; \
-	goto *switch_table_ops[last_opcode]
+#define DISPATCH_OPCODE        \
+	last_opcode = CODE(ip);    \
+	RECORD_OPCODE(last_opcode) \
+	goto *(t_threaded ? threaded_ops[ip].handler.load(std::memory_order_relaxed) : switch_table_ops[last_opcode])
 #else // !DEBUG_ENABLED
-#define DISPATCH_OPCODE goto *switch_table_ops[_code_ptr[ip]]
+#define DISPATCH_OPCODE     \
+	RECORD_OPCODE(CODE(ip)) \
+	goto *(t_threaded ? threaded_ops[ip].handler.load(std::memory_order_relaxed) : switch_table_ops[CODE(ip)])
 #endif // DEBUG_ENABLED
 
+// Instructions rewriting themselves must keep the shared threaded code in sync,
+// also when running the default loop, other threads may be running the threaded one.
+#define REWRITE_OPCODE(m_opcode)                                                                                    \
+	{                                                                                                               \
+		_write_opcode<t_compact>(ip, m_opcode);                                                                     \
+		ThreadedOp *rewritten_ops = t_threaded ? threaded_ops : _threaded_code_ptr.load(std::memory_order_acquire); \
+		if (rewritten_ops) {                                                                                        \
+			rewritten_ops[ip].handler.store(_threaded_handlers[m_opcode], std::memory_order_relaxed);               \
+		}                                                                                                           \
+	}
+
+// Operands of the threaded code, see `RuztaFunction::ThreadedOp`.
+// Threads resolving the same position at once store the same value.
+#define LOAD_RESOLVED_OPERAND(m_v, m_code_ofs) \
+	(t_threaded && _load_threaded_operand(threaded_ops[ip + 1 + (m_code_ofs)], stack, m_v))
+#define STORE_RESOLVED_OPERAND(m_code_ofs, m_address_type, m_address_index)                                                                 \
+	if (t_threaded && (m_address_type) != ADDR_TYPE_MEMBER) {                                                                                \
+		uintptr_t operand = (m_address_type) == ADDR_TYPE_STACK ? (((uintptr_t)(m_address_index) * sizeof(Variant)) << 1) | 1 : (uintptr_t)&_constants_ptr[m_address_index]; \
+		threaded_ops[ip + 1 + (m_code_ofs)].operand.store(operand, std::memory_order_relaxed);                                              \
+	}
+
 #define OPCODE_BREAK goto OPSEXIT
 #define OPCODE_OUT goto OPSOUT
 #else // !(defined(__GNUC__) || defined(__clang__))
@@ -444,12 +604,20 @@ void (*type_init_function_table[])(Variant *) = {
 
 #ifdef _MSC_VER
 #define OPCODE_SWITCH(m_test)       \
+	RECORD_OPCODE(m_test)           \
 	__assume(m_test <= OPCODE_END); \
 	switch (m_test)
 #else // !_MSC_VER
-#define OPCODE_SWITCH(m_test) switch (m_test)
+#define OPCODE_SWITCH(m_test) \
+	RECORD_OPCODE(m_test)     \
+	switch (m_test)
 #endif // _MSC_VER
 
+#define REWRITE_OPCODE(m_opcode) _write_opcode<t_compact>(ip, m_opcode);
+
+#define LOAD_RESOLVED_OPERAND(m_v, m_code_ofs) false
+#define STORE_RESOLVED_OPERAND(m_code_ofs, m_address_type, m_address_index)
+
 #define OPCODE_BREAK break
 #define OPCODE_OUT break
 #endif // defined(__GNUC__) || defined(__clang__)
@@ -496,10 +664,274 @@ void (*type_init_function_table[])(Variant *) = {
 #define METHOD_CALL_ON_NULL_VALUE_ERROR(method_pointer) "Cannot call method '" + (method_pointer)->get_name() + "' on a null value."
 #define METHOD_CALL_ON_FREED_INSTANCE_ERROR(method_pointer) "Cannot call method '" + (method_pointer)->get_name() + "' on a previously freed instance."
 
-Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, int p_argcount, GDExtensionCallError &r_err, CallState *p_state) {
+// The counter slot of a quickenable instruction keeps the consecutive type cache
+// hits in its low 16 bits and the number of deoptimizations in its high 16 bits.
+// Returns true exactly once, when the instruction should be rewritten.
+static _FORCE_INLINE_ bool _quicken_hit(int *p_counter) {
+	uint32_t counter = (uint32_t)*p_counter;
+	if ((counter & 0xFFFF) >= RuztaFunction::QUICKEN_WARMUP || (counter >> 16) >= RuztaFunction::QUICKEN_MAX_DEOPTS) {
+		return false;
+	}
+	counter++;
+	*p_counter = (int)counter;
+	return (counter & 0xFFFF) == RuztaFunction::QUICKEN_WARMUP && RuztaLanguage::get_singleton()->is_adaptive_quickening_enabled();
+}
+
+static _FORCE_INLINE_ void _quicken_miss(int *p_counter) {
+	*p_counter = (int)((uint32_t)*p_counter & 0xFFFF0000);
+}
+
+static _FORCE_INLINE_ void _quicken_deopt(int *p_counter) {
+	*p_counter = (int)((((uint32_t)*p_counter >> 16) + 1) << 16);
+}
+
+// Generators are iterated by resuming them directly, rather than through their `_iter_*()` methods.
+static _FORCE_INLINE_ RuztaFunctionState *_get_generator(const Variant *p_container) {
+	if (p_container->get_type() != Variant::OBJECT) {
+		return nullptr;
+	}
+	RuztaFunctionState *state = Object::cast_to<RuztaFunctionState>(p_container->get_validated_object());
+	return state && state->is_generator() ? state : nullptr;
+}
+
+// Arguments read from the caller's stack or constants outlive the call and can't be reassigned by the callee,
+// members can (through `self`), so those are always copied.
+static _FORCE_INLINE_ int _decode_address(int p_address) {
+	return p_address;
+}
+
+static _FORCE_INLINE_ int _decode_address(uint16_t p_address) {
+	return RuztaFunction::decode_compact_unit(p_address);
+}
+
+template <typename T>
+static _FORCE_INLINE_ uint64_t _get_stable_arguments(const T *p_arg_addresses, int p_argcount) {
+	uint64_t stable = 0;
+	for (int i = 0; i < MIN(p_argcount, 64); i++) {
+		if (((_decode_address(p_arg_addresses[i]) & RuztaFunction::ADDR_TYPE_MASK) >> RuztaFunction::ADDR_BITS) != RuztaFunction::ADDR_TYPE_MEMBER) {
+			stable |= uint64_t(1) << i;
+		}
+	}
+	return stable;
+}
+
+// A returned local is dead once the function exits, so its value can be moved out instead of copied.
+// Borrowed arguments belong to the caller and fixed addresses are shared, those are still copied.
+static _FORCE_INLINE_ bool _can_move_return(int p_address, uint64_t p_borrowed_args) {
+	if (((p_address & RuztaFunction::ADDR_TYPE_MASK) >> RuztaFunction::ADDR_BITS) != RuztaFunction::ADDR_TYPE_STACK) {
+		return false;
+	}
+	const int index = (p_address & RuztaFunction::ADDR_MASK) - RuztaFunction::FIXED_ADDRESSES_MAX;
+	return index >= 0 && (index >= 64 || !(p_borrowed_args & (uint64_t(1) << index)));
+}
+
+// Keyed accesses guard on the base type, plus the key and value types when the cached accessor needs them.
+// Values a typed Array would have to convert or check the class of never match, those take the generic path.
+static _FORCE_INLINE_ int _quicken_keyed_signature(int p_cache, const Variant *p_base, const Variant *p_key, const Variant *p_value) {
+	int signature = (p_cache & (RuztaFunction::QUICKEN_INDEXED | RuztaFunction::QUICKEN_VALUE_GUARD | RuztaFunction::QUICKEN_ELEMENT_GUARD)) | (p_base->get_type() << 16);
+	if (p_cache & RuztaFunction::QUICKEN_INDEXED) {
+		signature |= p_key->get_type() << 8;
+	}
+	if (p_cache & RuztaFunction::QUICKEN_VALUE_GUARD) {
+		signature |= p_value->get_type();
+	}
+	if ((p_cache & RuztaFunction::QUICKEN_ELEMENT_GUARD) && p_base->get_type() == Variant::ARRAY) {
+		const Array *array = VariantInternal::get_array(p_base);
+		if (array->is_typed() && (array->get_typed_builtin() != (uint32_t)p_value->get_type() || p_value->get_type() == Variant::OBJECT)) {
+			return RuztaFunction::QUICKEN_SIGNATURE_NONE;
+		}
+	}
+	return signature;
+}
+
+// Returns the member slot `p_name` maps to in instances of `p_instance`'s script, or nullptr when the
+// access has to take the generic path (getter/setter, not a member, guarded type, too many layouts).
+const RuztaFunction::MemberCache::Entry *RuztaFunction::_get_member_cache_entry(MemberCache *p_cache, const RuztaInstance *p_instance, const StringName &p_name, bool p_assign) {
+	const uint32_t layout_id = p_instance->script->member_layout_id;
+	if (unlikely(layout_id == 0)) {
+		return nullptr;
+	}
+
+	for (int i = 0; i < MemberCache::ENTRY_MAX; i++) {
+		const MemberCache::Entry &entry = p_cache->entries[i];
+		const uint32_t entry_layout_id = entry.layout_id.load(std::memory_order_acquire);
+		if (entry_layout_id == layout_id) {
+			return entry.index >= 0 ? &entry : nullptr;
+		}
+		if (entry_layout_id == 0) {
+			break;
+		}
+	}
+
+	if (p_cache->megamorphic) {
+		return nullptr;
+	}
+
+	static Mutex initializer_mutex;
+	MutexLock lock(initializer_mutex);
+
+	MemberCache::Entry *free_entry = nullptr;
+	for (int i = 0; i < MemberCache::ENTRY_MAX; i++) {
+		MemberCache::Entry &entry = p_cache->entries[i];
+		if (entry.layout_id.load(std::memory_order_relaxed) == layout_id) {
+			// Filled by another thread in the meantime.
+			return entry.index >= 0 ? &entry : nullptr;
+		}
+		if (entry.layout_id.load(std::memory_order_relaxed) == 0) {
+			free_entry = &entry;
+			break;
+		}
+	}
+
+	if (!free_entry) {
+		p_cache->megamorphic = true;
+		return nullptr;
+	}
+
+	HashMap<StringName, Ruzta::MemberInfo>::ConstIterator E = p_instance->script->member_indices.find(p_name);
+	if (E) {
+		const Ruzta::MemberInfo &member = E->value;
+		if (!p_assign && member.getter.is_empty()) {
+			free_entry->index = member.index;
+		} else if (p_assign && member.setter.is_empty()) {
+			// Only types that `RuztaDataType::is_type()` checks by builtin type alone can be guarded by the cache.
+			if (!member.data_type.has_type()) {
+				free_entry->index = member.index;
+			} else if (member.data_type.kind == RuztaDataType::BUILTIN && member.data_type.builtin_type != Variant::ARRAY && member.data_type.builtin_type != Variant::DICTIONARY) {
+				free_entry->index = member.index;
+				free_entry->type = member.data_type.builtin_type;
+			}
+		}
+	}
+
+	// Publish the entry last, readers don't take the lock.
+	free_entry->layout_id.store(layout_id, std::memory_order_release);
+	return free_entry->index >= 0 ? free_entry : nullptr;
+}
+
+// Returns the script function `p_method` resolves to on `p_instance`, as `RuztaInstance::callp()` would,
+// or nullptr when the call has to go through `Variant::callp()`.
+RuztaFunction *RuztaFunction::_get_call_cache_function(CallCache *p_cache, const RuztaInstance *p_instance, const StringName &p_method) {
+	const Ruzta *script = p_instance->script.ptr();
+	const uint32_t layout_id = script->member_layout_id;
+	if (unlikely(layout_id == 0 || !script->valid || !script->method_tables_valid)) {
+		return nullptr;
+	}
+
+	for (int i = 0; i < CallCache::ENTRY_MAX; i++) {
+		const CallCache::Entry &entry = p_cache->entries[i];
+		const uint32_t entry_layout_id = entry.layout_id.load(std::memory_order_acquire);
+		if (entry_layout_id == layout_id) {
+			return entry.function;
+		}
+		if (entry_layout_id == 0) {
+			break;
+		}
+	}
+
+	if (p_cache->megamorphic) {
+		return nullptr;
+	}
+
+	static Mutex initializer_mutex;
+	MutexLock lock(initializer_mutex);
+
+	CallCache::Entry *free_entry = nullptr;
+	for (int i = 0; i < CallCache::ENTRY_MAX; i++) {
+		CallCache::Entry &entry = p_cache->entries[i];
+		if (entry.layout_id.load(std::memory_order_relaxed) == layout_id) {
+			return entry.function;
+		}
+		if (entry.layout_id.load(std::memory_order_relaxed) == 0) {
+			free_entry = &entry;
+			break;
+		}
+	}
+
+	if (!free_entry) {
+		p_cache->megamorphic = true;
+		return nullptr;
+	}
+
+	// `_ready` also runs the implicit initializers, leave it to `callp()`.
+	if (p_method != RuztaLanguage::get_singleton()->strings._ready) {
+		// Recompiling a base gives its inheriters new layout ids, so the id also covers the base chain.
+		HashMap<StringName, RuztaFunction *>::ConstIterator E = script->method_table.find(p_method);
+		if (E) {
+			free_entry->function = E->value;
+		}
+	}
+
+	// Publish the entry last, readers don't take the lock.
+	free_entry->layout_id.store(layout_id, std::memory_order_release);
+	return free_entry->function;
+}
+
+// Returns the method bind `p_method` resolves to on `p_object`, a native object without a script,
+// or nullptr when the call has to go through `Variant::callp()`.
+MethodBind *RuztaFunction::_get_call_cache_method(CallCache *p_cache, Object *p_object, const StringName &p_method) {
+	const StringName native_class = p_object->get_class();
+
+	const int count = p_cache->native_count.load(std::memory_order_acquire);
+	for (int i = 0; i < count; i++) {
+		const CallCache::NativeEntry &entry = p_cache->native_entries[i];
+		if (entry.native_class == native_class) {
+			return entry.method;
+		}
+	}
+
+	if (p_cache->native_megamorphic) {
+		return nullptr;
+	}
+
+	static Mutex initializer_mutex;
+	MutexLock lock(initializer_mutex);
+
+	const int locked_count = p_cache->native_count.load(std::memory_order_relaxed);
+	for (int i = count; i < locked_count; i++) {
+		const CallCache::NativeEntry &entry = p_cache->native_entries[i];
+		if (entry.native_class == native_class) {
+			return entry.method;
+		}
+	}
+
+	if (locked_count == CallCache::ENTRY_MAX) {
+		p_cache->native_megamorphic = true;
+		return nullptr;
+	}
+
+	// Special methods such as `free` aren't bound, they keep going through `callp()`.
+	CallCache::NativeEntry &free_entry = p_cache->native_entries[locked_count];
+	free_entry.native_class = native_class;
+	free_entry.method = ClassDB::get_method(native_class, p_method);
+
+	// Publish the entry last, readers don't take the lock.
+	p_cache->native_count.store(locked_count + 1, std::memory_order_release);
+	return free_entry.method;
+}
+
+const void *const *RuztaFunction::_threaded_handlers = nullptr;
+
+Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, int p_argcount, GDExtensionCallError &r_err, CallState *p_state, bool p_validated_args, uint64_t p_stable_args) {
+	if (_compact_code_ptr) {
+		return _call<false, true>(p_instance, p_args, p_argcount, r_err, p_state, p_validated_args, p_stable_args);
+	}
+#if defined(__GNUC__) || defined(__clang__)
+	if (_threaded_code_ptr.load(std::memory_order_relaxed) != nullptr) {
+		return _call<true, false>(p_instance, p_args, p_argcount, r_err, p_state, p_validated_args, p_stable_args);
+	}
+	if (unlikely(RuztaLanguage::get_singleton()->is_threaded_dispatch_enabled()) && _threaded_call_count.fetch_add(1, std::memory_order_relaxed) + 1 >= THREADED_DISPATCH_CALLS && !EngineDebugger::get_singleton()->is_active()) {
+		return _call<true, false>(p_instance, p_args, p_argcount, r_err, p_state, p_validated_args, p_stable_args);
+	}
+#endif
+	return _call<false, false>(p_instance, p_args, p_argcount, r_err, p_state, p_validated_args, p_stable_args);
+}
+
+template <bool t_threaded, bool t_compact>
+Variant RuztaFunction::_call(RuztaInstance *p_instance, const Variant **p_args, int p_argcount, GDExtensionCallError &r_err, CallState *p_state, bool p_validated_args, uint64_t p_stable_args) {
 	OPCODES_TABLE;
 
-	if (!_code_ptr) {
+	if (!_code_size) {
 		return _get_default_variant_for_data_type(return_type);
 	}
 
@@ -530,10 +962,15 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 		return _get_default_variant_for_data_type(return_type);
 	}
 
+	// Releases this call's frame on every return path, resumed calls don't take one.
+	RuztaFrameArena::Scope frame_scope(frame_arena);
+
 	Variant retvalue;
 	Variant *stack = nullptr;
 	Variant **instruction_args = nullptr;
+	Vector<uint8_t> heap_frame; // Only used by coroutines.
 	int defarg = 0;
+	uint64_t borrowed_args = 0; // Stack slots sharing the caller's argument bits, they are forgotten rather than destroyed.
 
 	uint32_t alloca_size = 0;
 	Ruzta *script;
@@ -572,19 +1009,30 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 
 		alloca_size = sizeof(Variant *) * FIXED_ADDRESSES_MAX + sizeof(Variant *) * _instruction_args_size + sizeof(Variant) * _stack_size;
 
-		uint8_t *aptr = (uint8_t *)alloca(alloca_size);
+		uint8_t *aptr;
+		if (_coroutine) {
+			// A frame that may suspend lives on the heap from the start,
+			// so `await` can hand it to the function state without copies.
+			heap_frame.resize(alloca_size);
+			aptr = heap_frame.ptrw();
+		} else {
+			aptr = frame_arena.alloc(alloca_size);
+		}
 		stack = (Variant *)aptr;
 
+		// Read-only arguments the caller keeps alive are borrowed: the slot takes the caller's bits without a reference.
+		const uint64_t borrowable_args = p_stable_args & _read_only_arguments;
 		const int non_vararg_arg_count = MIN(p_argcount, _argument_count);
 		for (int i = 0; i < non_vararg_arg_count; i++) {
-			if (!argument_types[i].has_type()) {
-				memnew_placement(&stack[i + FIXED_ADDRESSES_MAX], Variant(*p_args[i]));
-				continue;
-			}
 			// If types already match, don't call RuztaVariantExtension::construct(). Constructors of some types
 			// (e.g. packed arrays) do copies, whereas they pass by reference when inside a Variant.
-			if (argument_types[i].is_type(*p_args[i], false)) {
-				memnew_placement(&stack[i + FIXED_ADDRESSES_MAX], Variant(*p_args[i]));
+			if (p_validated_args || !argument_types[i].has_type() || argument_types[i].is_type(*p_args[i], false)) {
+				if (i < 64 && (borrowable_args & (uint64_t(1) << i))) {
+					memcpy((void *)&stack[i + FIXED_ADDRESSES_MAX], (const void *)p_args[i], sizeof(Variant));
+					borrowed_args |= uint64_t(1) << i;
+				} else {
+					memnew_placement(&stack[i + FIXED_ADDRESSES_MAX], Variant(*p_args[i]));
+				}
 				continue;
 			}
 			if (!argument_types[i].is_type(*p_args[i], true)) {
@@ -641,8 +1089,8 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 			instruction_args = nullptr;
 		}
 
-		for (const KeyValue<int, Variant::Type> &E : temporary_slots) {
-			type_init_function_table[E.value](&stack[E.key]);
+		for (int i = 0; i < _temporary_slots_count; i++) {
+			type_init_function_table[_temporary_slots_ptr[i].type](&stack[_temporary_slots_ptr[i].stack_index]);
 		}
 	}
 
@@ -658,8 +1106,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 
 	String err_text;
 
-	RuztaLanguage::CallLevel call_level;
-	RuztaLanguage::get_singleton()->enter_function(&call_level, p_instance, this, stack, &ip, &line);
+	RuztaLanguage::get_singleton()->enter_function(p_instance, this, stack, &ip);
 
 #ifdef DEBUG_ENABLED
 #define GD_ERR_BREAK(m_cond)                                                                                           \
@@ -675,8 +1122,8 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 
 #define GET_VARIANT_PTR(m_v, m_code_ofs)                                                            \
 	Variant *m_v;                                                                                   \
-	{                                                                                               \
-		int address = _code_ptr[ip + 1 + (m_code_ofs)];                                             \
+	if (!LOAD_RESOLVED_OPERAND(m_v, m_code_ofs)) {                                                  \
+		int address = CODE(ip + 1 + (m_code_ofs));                                                  \
 		int address_type = (address & ADDR_TYPE_MASK) >> ADDR_BITS;                                 \
 		if (unlikely(address_type < 0 || address_type >= ADDR_TYPE_MAX)) {                          \
 			err_text = "Bad address type.";                                                         \
@@ -694,25 +1141,29 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 		m_v = &variant_addresses[address_type][address_index];                                      \
 		if (unlikely(!m_v))                                                                         \
 			OPCODE_BREAK;                                                                           \
+		STORE_RESOLVED_OPERAND(m_code_ofs, address_type, address_index)                             \
 	}
 
 #else // !DEBUG_ENABLED
 #define GD_ERR_BREAK(m_cond)
 #define CHECK_SPACE(m_space)
 
-#define GET_VARIANT_PTR(m_v, m_code_ofs)                                                        \
-	Variant *m_v;                                                                               \
-	{                                                                                           \
-		int address = _code_ptr[ip + 1 + (m_code_ofs)];                                         \
-		m_v = &variant_addresses[(address & ADDR_TYPE_MASK) >> ADDR_BITS][address & ADDR_MASK]; \
-		if (unlikely(!m_v))                                                                     \
-			OPCODE_BREAK;                                                                       \
+#define GET_VARIANT_PTR(m_v, m_code_ofs)                                \
+	Variant *m_v;                                                       \
+	if (!LOAD_RESOLVED_OPERAND(m_v, m_code_ofs)) {                      \
+		int address = CODE(ip + 1 + (m_code_ofs));                      \
+		int address_type = (address & ADDR_TYPE_MASK) >> ADDR_BITS;     \
+		int address_index = address & ADDR_MASK;                        \
+		m_v = &variant_addresses[address_type][address_index];          \
+		if (unlikely(!m_v))                                             \
+			OPCODE_BREAK;                                               \
+		STORE_RESOLVED_OPERAND(m_code_ofs, address_type, address_index) \
 	}
 
 #endif // DEBUG_ENABLED
 
 #define LOAD_INSTRUCTION_ARGS                   \
-	int instr_arg_count = _code_ptr[ip + 1];    \
+	int instr_arg_count = CODE(ip + 1);         \
 	for (int i = 0; i < instr_arg_count; i++) { \
 		GET_VARIANT_PTR(v, i + 1);              \
 		instruction_args[i] = v;                \
@@ -722,51 +1173,94 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 #define GET_INSTRUCTION_ARG(m_v, m_idx) \
 	Variant *m_v = instruction_args[m_idx]
 
+// Reads a property of the native object behind `self`, for GET_MEMBER and the superinstructions starting with it.
+#ifdef DEBUG_ENABLED
+#define GET_MEMBER_PROPERTY(m_dst, m_name)                               \
+	if (!ClassDB::get_property(p_instance->owner, m_name, *m_dst)) {     \
+		err_text = "Internal error getting property: " + String(m_name); \
+		OPCODE_BREAK;                                                    \
+	}
+#else // !DEBUG_ENABLED
+#define GET_MEMBER_PROPERTY(m_dst, m_name) ClassDB::get_property(p_instance->owner, m_name, *m_dst)
+#endif // DEBUG_ENABLED
+
 #ifdef DEBUG_ENABLED
 	uint64_t function_start_time = 0;
 	uint64_t function_call_time = 0;
+	Profile::ThreadCounts *profile_counts = nullptr;
 
 	if (RuztaLanguage::get_singleton()->profiling) {
 		function_start_time = OS::get_singleton()->get_ticks_usec();
 		function_call_time = 0;
-		profile.call_count.increment();
-		profile.frame_call_count.increment();
+		profile_counts = _get_profile_thread_counts();
+		Profile::ThreadCounts::add(profile_counts->call_count, 1);
 	}
 	bool exit_ok = false;
 	int variant_address_limits[ADDR_TYPE_MAX] = { _stack_size, _constant_count, p_instance ? (int)p_instance->members.size() : 0 };
 #endif
 
+#if defined(__GNUC__) || defined(__clang__)
+	ThreadedOp *threaded_ops = nullptr;
+	if (t_threaded) {
+		threaded_ops = _threaded_code_ptr.load(std::memory_order_acquire);
+		if (unlikely(!threaded_ops)) {
+			static Mutex threaded_code_mutex;
+			MutexLock lock(threaded_code_mutex);
+			threaded_ops = _threaded_code_ptr.load(std::memory_order_acquire);
+			if (!threaded_ops) {
+				// Label addresses are per instantiation, rewrites in the default loop patch with these.
+				_threaded_handlers = switch_table_ops;
+				threaded_ops = memnew_arr(ThreadedOp, _code_size);
+				for (int i = 0; i < _code_size; i++) {
+					// Operand positions get a handler too, they are never dispatched.
+					const int code = _read_code<false>(i);
+					threaded_ops[i].handler.store((uint32_t)code <= OPCODE_END ? switch_table_ops[code] : nullptr, std::memory_order_relaxed);
+				}
+				_threaded_code_ptr.store(threaded_ops, std::memory_order_release);
+			}
+		}
+	}
+#endif
+
+#ifdef RUZTA_OPCODE_STATS
+	RuztaOpcodeStats::Recorder opcode_recorder(this);
+#endif
+
 	bool awaited = false;
+	bool frame_handed_over = false; // The state owns the stack now, don't free it here.
 	Variant *variant_addresses[ADDR_TYPE_MAX] = { stack, _constants_ptr, p_instance ? p_instance->members.ptrw() : nullptr };
 
 #ifdef DEBUG_ENABLED
 	OPCODE_WHILE(ip < _code_size) {
-		int last_opcode = _code_ptr[ip];
+		int last_opcode = CODE(ip);
 #else
 	OPCODE_WHILE(true) {
 #endif
 
-		OPCODE_SWITCH(_code_ptr[ip]) {
+		OPCODE_SWITCH(CODE(ip)) {
 			OPCODE(OPCODE_OPERATOR) {
-				constexpr int _pointer_size = sizeof(RuztaVariantExtension::ValidatedOperatorEvaluator) / sizeof(*_code_ptr);
-				CHECK_SPACE(7 + _pointer_size);
+				CHECK_SPACE(6);
+
+				int site_cache_idx = CODE(ip + 5);
+				GD_ERR_BREAK(site_cache_idx < 0 || site_cache_idx >= _site_caches_count);
+				SiteCache *site_cache = &_site_caches_ptr[site_cache_idx];
 
 				bool valid;
-				Variant::Operator op = (Variant::Operator)_code_ptr[ip + 4];
+				Variant::Operator op = (Variant::Operator)CODE(ip + 4);
 				GD_ERR_BREAK(op >= Variant::OP_MAX);
 
 				GET_VARIANT_PTR(a, 0);
 				GET_VARIANT_PTR(b, 1);
 				GET_VARIANT_PTR(dst, 2);
 				// Compute signatures (types of operands) so it can be optimized when matching.
-				uint32_t op_signature = _code_ptr[ip + 5];
+				uint32_t op_signature = site_cache->signature;
 				uint32_t actual_signature = (a->get_type() << 8) | (b->get_type());
 
 #ifdef DEBUG_ENABLED
 				if (op == Variant::OP_DIVIDE || op == Variant::OP_MODULE) {
 					// Don't optimize division and modulo since there's not check for division by zero with validated calls.
 					op_signature = 0xFFFF;
-					_code_ptr[ip + 5] = op_signature;
+					site_cache->signature = op_signature;
 				}
 #endif
 
@@ -791,23 +1285,29 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 						op_func(a, b, dst);
 
 						// Check again in case another thread already set it.
-						if (_code_ptr[ip + 5] == 0) {
-							_code_ptr[ip + 5] = actual_signature;
-							_code_ptr[ip + 6] = static_cast<int>(ret_type);
-							RuztaVariantExtension::ValidatedOperatorEvaluator *tmp = reinterpret_cast<RuztaVariantExtension::ValidatedOperatorEvaluator *>(&_code_ptr[ip + 7]);
-							*tmp = op_func;
+						if (site_cache->signature == 0) {
+							site_cache->function = reinterpret_cast<SiteCache::Function>(op_func);
+							site_cache->return_type = static_cast<int>(ret_type);
+							site_cache->signature = actual_signature;
 						}
 					}
 					initializer_mutex.unlock();
 				} else if (likely(op_signature == actual_signature)) {
+					// If the signature keeps matching, switch to the quickened form.
+					if (unlikely(_quicken_hit(&site_cache->counter))) {
+						REWRITE_OPCODE(OPCODE_OPERATOR_QUICKENED);
+					}
+
 					// If the signature matches, we can use the optimized path.
-					Variant::Type ret_type = static_cast<Variant::Type>(_code_ptr[ip + 6]);
-					RuztaVariantExtension::ValidatedOperatorEvaluator op_func = *reinterpret_cast<RuztaVariantExtension::ValidatedOperatorEvaluator *>(&_code_ptr[ip + 7]);
+					Variant::Type ret_type = static_cast<Variant::Type>(site_cache->return_type);
+					RuztaVariantExtension::ValidatedOperatorEvaluator op_func = reinterpret_cast<RuztaVariantExtension::ValidatedOperatorEvaluator>(site_cache->function);
 
 					// Make sure the return value has the correct type.
 					VariantInternal::initialize(dst, ret_type);
 					op_func(a, b, dst);
 				} else {
+					_quicken_miss(&site_cache->counter);
+
 					// If the signature doesn't match, we have to use the slow path.
 #ifdef DEBUG_ENABLED
 
@@ -830,14 +1330,14 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 					*dst = ret;
 #endif
 				}
-				ip += 7 + _pointer_size;
+				ip += 6;
 			}
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_OPERATOR_VALIDATED) {
 				CHECK_SPACE(5);
 
-				int operator_idx = _code_ptr[ip + 4];
+				int operator_idx = CODE(ip + 4);
 				GD_ERR_BREAK(operator_idx < 0 || operator_idx >= _operator_funcs_count);
 				RuztaVariantExtension::ValidatedOperatorEvaluator operator_func = _operator_funcs_ptr[operator_idx];
 
@@ -851,13 +1351,136 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_OPERATOR_QUICKENED) {
+				CHECK_SPACE(6);
+
+				int site_cache_idx = CODE(ip + 5);
+				GD_ERR_BREAK(site_cache_idx < 0 || site_cache_idx >= _site_caches_count);
+				SiteCache *site_cache = &_site_caches_ptr[site_cache_idx];
+
+				GET_VARIANT_PTR(a, 0);
+				GET_VARIANT_PTR(b, 1);
+				GET_VARIANT_PTR(dst, 2);
+
+				uint32_t actual_signature = (a->get_type() << 8) | (b->get_type());
+				if (unlikely((uint32_t)site_cache->signature != actual_signature)) {
+					// Types changed, fall back to the generic form.
+					_quicken_deopt(&site_cache->counter);
+					REWRITE_OPCODE(OPCODE_OPERATOR);
+					DISPATCH_OPCODE;
+				}
+
+				Variant::Type ret_type = static_cast<Variant::Type>(site_cache->return_type);
+				RuztaVariantExtension::ValidatedOperatorEvaluator op_func = reinterpret_cast<RuztaVariantExtension::ValidatedOperatorEvaluator>(site_cache->function);
+
+				VariantInternal::initialize(dst, ret_type);
+				op_func(a, b, dst);
+
+				ip += 6;
+			}
+			DISPATCH_OPCODE;
+
+			// Operands and target are statically typed, so the values are read and written in place.
+#define OPCODE_OPERATOR_UNBOXED(m_name, m_ret, m_left, m_right, m_op)                                                                     \
+	OPCODE(OPCODE_OPERATOR_##m_name) {                                                                                                    \
+		CHECK_SPACE(4);                                                                                                                   \
+		GET_VARIANT_PTR(a, 0);                                                                                                            \
+		GET_VARIANT_PTR(b, 1);                                                                                                            \
+		GET_VARIANT_PTR(dst, 2);                                                                                                          \
+		VariantInternalAccessor<m_ret>::get(dst) = VariantInternalAccessor<m_left>::get(a) m_op VariantInternalAccessor<m_right>::get(b); \
+		ip += 4;                                                                                                                          \
+	}                                                                                                                                     \
+	DISPATCH_OPCODE
+
+			OPCODE_OPERATOR_UNBOXED(ADD_INT, int64_t, int64_t, int64_t, +);
+			OPCODE_OPERATOR_UNBOXED(SUB_INT, int64_t, int64_t, int64_t, -);
+			OPCODE_OPERATOR_UNBOXED(MUL_INT, int64_t, int64_t, int64_t, *);
+			OPCODE_OPERATOR_UNBOXED(EQUAL_INT, bool, int64_t, int64_t, ==);
+			OPCODE_OPERATOR_UNBOXED(NOT_EQUAL_INT, bool, int64_t, int64_t, !=);
+			OPCODE_OPERATOR_UNBOXED(LESS_INT, bool, int64_t, int64_t, <);
+			OPCODE_OPERATOR_UNBOXED(LESS_EQUAL_INT, bool, int64_t, int64_t, <=);
+			OPCODE_OPERATOR_UNBOXED(GREATER_INT, bool, int64_t, int64_t, >);
+			OPCODE_OPERATOR_UNBOXED(GREATER_EQUAL_INT, bool, int64_t, int64_t, >=);
+			OPCODE_OPERATOR_UNBOXED(ADD_FLOAT, double, double, double, +);
+			OPCODE_OPERATOR_UNBOXED(SUB_FLOAT, double, double, double, -);
+			OPCODE_OPERATOR_UNBOXED(MUL_FLOAT, double, double, double, *);
+			OPCODE_OPERATOR_UNBOXED(DIV_FLOAT, double, double, double, /);
+			OPCODE_OPERATOR_UNBOXED(EQUAL_FLOAT, bool, double, double, ==);
+			OPCODE_OPERATOR_UNBOXED(NOT_EQUAL_FLOAT, bool, double, double, !=);
+			OPCODE_OPERATOR_UNBOXED(LESS_FLOAT, bool, double, double, <);
+			OPCODE_OPERATOR_UNBOXED(LESS_EQUAL_FLOAT, bool, double, double, <=);
+			OPCODE_OPERATOR_UNBOXED(GREATER_FLOAT, bool, double, double, >);
+			OPCODE_OPERATOR_UNBOXED(GREATER_EQUAL_FLOAT, bool, double, double, >=);
+			OPCODE_OPERATOR_UNBOXED(ADD_VECTOR2, Vector2, Vector2, Vector2, +);
+			OPCODE_OPERATOR_UNBOXED(SUB_VECTOR2, Vector2, Vector2, Vector2, -);
+			OPCODE_OPERATOR_UNBOXED(MUL_VECTOR2, Vector2, Vector2, Vector2, *);
+			OPCODE_OPERATOR_UNBOXED(MUL_VECTOR2_FLOAT, Vector2, Vector2, double, *);
+			OPCODE_OPERATOR_UNBOXED(ADD_VECTOR3, Vector3, Vector3, Vector3, +);
+			OPCODE_OPERATOR_UNBOXED(SUB_VECTOR3, Vector3, Vector3, Vector3, -);
+			OPCODE_OPERATOR_UNBOXED(MUL_VECTOR3, Vector3, Vector3, Vector3, *);
+			OPCODE_OPERATOR_UNBOXED(MUL_VECTOR3_FLOAT, Vector3, Vector3, double, *);
+
+			OPCODE(OPCODE_JUMP_IF_NOT_OPERATOR_VALIDATED) {
+				CHECK_SPACE(6);
+
+				int operator_idx = CODE(ip + 4);
+				GD_ERR_BREAK(operator_idx < 0 || operator_idx >= _operator_funcs_count);
+				RuztaVariantExtension::ValidatedOperatorEvaluator operator_func = _operator_funcs_ptr[operator_idx];
+
+				GET_VARIANT_PTR(a, 0);
+				GET_VARIANT_PTR(b, 1);
+				GET_VARIANT_PTR(dst, 2);
+
+				operator_func(a, b, dst);
+
+				if (!dst->booleanize()) {
+					int to = CODE(ip + 5);
+					GD_ERR_BREAK(to < 0 || to > _code_size);
+					ip = to;
+				} else {
+					ip += 6;
+				}
+			}
+			DISPATCH_OPCODE;
+
+#define OPCODE_JUMP_IF_NOT_UNBOXED(m_name, m_type, m_op)                                                    \
+	OPCODE(OPCODE_JUMP_IF_NOT_##m_name) {                                                                   \
+		CHECK_SPACE(5);                                                                                     \
+		GET_VARIANT_PTR(a, 0);                                                                              \
+		GET_VARIANT_PTR(b, 1);                                                                              \
+		GET_VARIANT_PTR(dst, 2);                                                                            \
+		bool result = VariantInternalAccessor<m_type>::get(a) m_op VariantInternalAccessor<m_type>::get(b); \
+		VariantInternalAccessor<bool>::get(dst) = result;                                                   \
+		if (!result) {                                                                                      \
+			int to = CODE(ip + 4);                                                                          \
+			GD_ERR_BREAK(to < 0 || to > _code_size);                                                        \
+			ip = to;                                                                                        \
+		} else {                                                                                            \
+			ip += 5;                                                                                        \
+		}                                                                                                   \
+	}                                                                                                       \
+	DISPATCH_OPCODE
+
+			OPCODE_JUMP_IF_NOT_UNBOXED(EQUAL_INT, int64_t, ==);
+			OPCODE_JUMP_IF_NOT_UNBOXED(NOT_EQUAL_INT, int64_t, !=);
+			OPCODE_JUMP_IF_NOT_UNBOXED(LESS_INT, int64_t, <);
+			OPCODE_JUMP_IF_NOT_UNBOXED(LESS_EQUAL_INT, int64_t, <=);
+			OPCODE_JUMP_IF_NOT_UNBOXED(GREATER_INT, int64_t, >);
+			OPCODE_JUMP_IF_NOT_UNBOXED(GREATER_EQUAL_INT, int64_t, >=);
+			OPCODE_JUMP_IF_NOT_UNBOXED(EQUAL_FLOAT, double, ==);
+			OPCODE_JUMP_IF_NOT_UNBOXED(NOT_EQUAL_FLOAT, double, !=);
+			OPCODE_JUMP_IF_NOT_UNBOXED(LESS_FLOAT, double, <);
+			OPCODE_JUMP_IF_NOT_UNBOXED(LESS_EQUAL_FLOAT, double, <=);
+			OPCODE_JUMP_IF_NOT_UNBOXED(GREATER_FLOAT, double, >);
+			OPCODE_JUMP_IF_NOT_UNBOXED(GREATER_EQUAL_FLOAT, double, >=);
+
 			OPCODE(OPCODE_TYPE_TEST_BUILTIN) {
 				CHECK_SPACE(4);
 
 				GET_VARIANT_PTR(dst, 0);
 				GET_VARIANT_PTR(value, 1);
 
-				Variant::Type builtin_type = (Variant::Type)_code_ptr[ip + 3];
+				Variant::Type builtin_type = (Variant::Type)CODE(ip + 3);
 				GD_ERR_BREAK(builtin_type < 0 || builtin_type >= Variant::VARIANT_MAX);
 
 				*dst = value->get_type() == builtin_type;
@@ -872,8 +1495,8 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				GET_VARIANT_PTR(value, 1);
 
 				GET_VARIANT_PTR(script_type, 2);
-				Variant::Type builtin_type = (Variant::Type)_code_ptr[ip + 4];
-				int native_type_idx = _code_ptr[ip + 5];
+				Variant::Type builtin_type = (Variant::Type)CODE(ip + 4);
+				int native_type_idx = CODE(ip + 5);
 				GD_ERR_BREAK(native_type_idx < 0 || native_type_idx >= _global_names_count);
 				const StringName native_type = _global_names_ptr[native_type_idx];
 
@@ -895,14 +1518,14 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				GET_VARIANT_PTR(value, 1);
 
 				GET_VARIANT_PTR(key_script_type, 2);
-				Variant::Type key_builtin_type = (Variant::Type)_code_ptr[ip + 5];
-				int key_native_type_idx = _code_ptr[ip + 6];
+				Variant::Type key_builtin_type = (Variant::Type)CODE(ip + 5);
+				int key_native_type_idx = CODE(ip + 6);
 				GD_ERR_BREAK(key_native_type_idx < 0 || key_native_type_idx >= _global_names_count);
 				const StringName key_native_type = _global_names_ptr[key_native_type_idx];
 
 				GET_VARIANT_PTR(value_script_type, 3);
-				Variant::Type value_builtin_type = (Variant::Type)_code_ptr[ip + 7];
-				int value_native_type_idx = _code_ptr[ip + 8];
+				Variant::Type value_builtin_type = (Variant::Type)CODE(ip + 7);
+				int value_native_type_idx = CODE(ip + 8);
 				GD_ERR_BREAK(value_native_type_idx < 0 || value_native_type_idx >= _global_names_count);
 				const StringName value_native_type = _global_names_ptr[value_native_type_idx];
 
@@ -924,7 +1547,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				GET_VARIANT_PTR(dst, 0);
 				GET_VARIANT_PTR(value, 1);
 
-				int native_type_idx = _code_ptr[ip + 3];
+				int native_type_idx = CODE(ip + 3);
 				GD_ERR_BREAK(native_type_idx < 0 || native_type_idx >= _global_names_count);
 				const StringName native_type = _global_names_ptr[native_type_idx];
 
@@ -974,12 +1597,50 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_SET_KEYED) {
-				CHECK_SPACE(3);
+				CHECK_SPACE(5);
+
+				int site_cache_idx = CODE(ip + 4);
+				GD_ERR_BREAK(site_cache_idx < 0 || site_cache_idx >= _site_caches_count);
+				SiteCache *site_cache = &_site_caches_ptr[site_cache_idx];
 
 				GET_VARIANT_PTR(dst, 0);
 				GET_VARIANT_PTR(index, 1);
 				GET_VARIANT_PTR(value, 2);
 
+				// Check if this is the first run. If so, resolve a validated setter for the current types.
+				if (unlikely(site_cache->signature == 0) && dst->get_type() != Variant::NIL) {
+					static Mutex initializer_mutex;
+					initializer_mutex.lock();
+					if (site_cache->signature == 0) {
+						Variant::Type base_type = dst->get_type();
+						int cache = QUICKEN_SIGNATURE_NONE;
+						// Objects may be freed between executions, validated setters can't handle that.
+						if (base_type != Variant::OBJECT) {
+							RuztaVariantExtension::ValidatedIndexedSetter indexed_setter = RuztaVariantExtension::get_member_validated_indexed_setter(base_type);
+							Variant::Type element_type = RuztaVariantExtension::get_indexed_element_type(base_type);
+							RuztaVariantExtension::ValidatedKeyedSetter keyed_setter = RuztaVariantExtension::get_member_validated_keyed_setter(base_type);
+							if (indexed_setter && index->get_type() == Variant::INT && (element_type == Variant::NIL || element_type == value->get_type())) {
+								site_cache->function = reinterpret_cast<SiteCache::Function>(indexed_setter);
+								cache = _quicken_keyed_signature(QUICKEN_INDEXED | (element_type != Variant::NIL ? QUICKEN_VALUE_GUARD : 0) | (base_type == Variant::ARRAY ? QUICKEN_ELEMENT_GUARD : 0), dst, index, value);
+							} else if (keyed_setter) {
+								site_cache->function = reinterpret_cast<SiteCache::Function>(keyed_setter);
+								cache = _quicken_keyed_signature(0, dst, index, value);
+							}
+						}
+						site_cache->signature = cache;
+					}
+					initializer_mutex.unlock();
+				}
+
+				int cache = site_cache->signature;
+				if (cache > 0 && _quicken_keyed_signature(cache, dst, index, value) == cache) {
+					if (unlikely(_quicken_hit(&site_cache->counter))) {
+						REWRITE_OPCODE(OPCODE_SET_KEYED_QUICKENED);
+					}
+				} else {
+					_quicken_miss(&site_cache->counter);
+				}
+
 				bool valid;
 #ifdef DEBUG_ENABLED
 				Variant::VariantSetError err_code;
@@ -1015,7 +1676,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 					OPCODE_BREAK;
 				}
 #endif
-				ip += 4;
+				ip += 5;
 			}
 			DISPATCH_OPCODE;
 
@@ -1026,7 +1687,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				GET_VARIANT_PTR(index, 1);
 				GET_VARIANT_PTR(value, 2);
 
-				int index_setter = _code_ptr[ip + 4];
+				int index_setter = CODE(ip + 4);
 				GD_ERR_BREAK(index_setter < 0 || index_setter >= _keyed_setters_count);
 				const RuztaVariantExtension::ValidatedKeyedSetter setter = _keyed_setters_ptr[index_setter];
 
@@ -1060,7 +1721,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				GET_VARIANT_PTR(index, 1);
 				GET_VARIANT_PTR(value, 2);
 
-				int index_setter = _code_ptr[ip + 4];
+				int index_setter = CODE(ip + 4);
 				GD_ERR_BREAK(index_setter < 0 || index_setter >= _indexed_setters_count);
 				const RuztaVariantExtension::ValidatedIndexedSetter setter = _indexed_setters_ptr[index_setter];
 
@@ -1089,13 +1750,104 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_SET_KEYED_QUICKENED) {
+				CHECK_SPACE(5);
+
+				int site_cache_idx = CODE(ip + 4);
+				GD_ERR_BREAK(site_cache_idx < 0 || site_cache_idx >= _site_caches_count);
+				SiteCache *site_cache = &_site_caches_ptr[site_cache_idx];
+
+				GET_VARIANT_PTR(dst, 0);
+				GET_VARIANT_PTR(index, 1);
+				GET_VARIANT_PTR(value, 2);
+
+				int cache = site_cache->signature;
+				if (unlikely(_quicken_keyed_signature(cache, dst, index, value) != cache)) {
+					// Types changed, fall back to the generic form.
+					_quicken_deopt(&site_cache->counter);
+					REWRITE_OPCODE(OPCODE_SET_KEYED);
+					DISPATCH_OPCODE;
+				}
+
+				bool valid;
+				if (cache & QUICKEN_INDEXED) {
+					const RuztaVariantExtension::ValidatedIndexedSetter setter = reinterpret_cast<RuztaVariantExtension::ValidatedIndexedSetter>(site_cache->function);
+					bool oob;
+					setter(dst, *VariantInternal::get_int(index), value, &oob);
+					valid = !oob;
+				} else {
+					const RuztaVariantExtension::ValidatedKeyedSetter setter = reinterpret_cast<RuztaVariantExtension::ValidatedKeyedSetter>(site_cache->function);
+					setter(dst, index, value, &valid);
+				}
+
+#ifdef DEBUG_ENABLED
+				if (!valid) {
+					if (dst->is_read_only()) {
+						err_text = "Invalid assignment on read-only value (on base: '" + _get_var_type(dst) + "').";
+					} else {
+						String v = index->operator String();
+						if (!v.is_empty()) {
+							v = "'" + v + "'";
+						} else {
+							v = "of type '" + _get_var_type(index) + "'";
+						}
+						if (cache & QUICKEN_INDEXED) {
+							err_text = "Out of bounds set index " + v + " (on base: '" + _get_var_type(dst) + "')";
+						} else {
+							err_text = "Invalid assignment of property or key " + v + " with value of type '" + _get_var_type(value) + "' on a base object of type '" + _get_var_type(dst) + "'.";
+						}
+					}
+					OPCODE_BREAK;
+				}
+#endif
+				ip += 5;
+			}
+			DISPATCH_OPCODE;
+
 			OPCODE(OPCODE_GET_KEYED) {
-				CHECK_SPACE(3);
+				CHECK_SPACE(5);
+
+				int site_cache_idx = CODE(ip + 4);
+				GD_ERR_BREAK(site_cache_idx < 0 || site_cache_idx >= _site_caches_count);
+				SiteCache *site_cache = &_site_caches_ptr[site_cache_idx];
 
 				GET_VARIANT_PTR(src, 0);
 				GET_VARIANT_PTR(index, 1);
 				GET_VARIANT_PTR(dst, 2);
 
+				// Check if this is the first run. If so, resolve a validated getter for the current types.
+				if (unlikely(site_cache->signature == 0) && src->get_type() != Variant::NIL) {
+					static Mutex initializer_mutex;
+					initializer_mutex.lock();
+					if (site_cache->signature == 0) {
+						Variant::Type base_type = src->get_type();
+						int cache = QUICKEN_SIGNATURE_NONE;
+						// Objects may be freed between executions, validated getters can't handle that.
+						if (base_type != Variant::OBJECT) {
+							RuztaVariantExtension::ValidatedIndexedGetter indexed_getter = RuztaVariantExtension::get_member_validated_indexed_getter(base_type);
+							RuztaVariantExtension::ValidatedKeyedGetter keyed_getter = RuztaVariantExtension::get_member_validated_keyed_getter(base_type);
+							if (indexed_getter && index->get_type() == Variant::INT) {
+								site_cache->function = reinterpret_cast<SiteCache::Function>(indexed_getter);
+								cache = _quicken_keyed_signature(QUICKEN_INDEXED, src, index, nullptr);
+							} else if (keyed_getter) {
+								site_cache->function = reinterpret_cast<SiteCache::Function>(keyed_getter);
+								cache = _quicken_keyed_signature(0, src, index, nullptr);
+							}
+						}
+						site_cache->signature = cache;
+					}
+					initializer_mutex.unlock();
+				}
+
+				int cache = site_cache->signature;
+				if (cache > 0 && _quicken_keyed_signature(cache, src, index, nullptr) == cache) {
+					if (unlikely(_quicken_hit(&site_cache->counter))) {
+						REWRITE_OPCODE(OPCODE_GET_KEYED_QUICKENED);
+					}
+				} else {
+					_quicken_miss(&site_cache->counter);
+				}
+
 				bool valid;
 #ifdef DEBUG_ENABLED
 				// Allow better error message in cases where src and dst are the same stack position.
@@ -1121,7 +1873,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				}
 				*dst = ret;
 #endif
-				ip += 4;
+				ip += 5;
 			}
 			DISPATCH_OPCODE;
 
@@ -1132,7 +1884,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				GET_VARIANT_PTR(key, 1);
 				GET_VARIANT_PTR(dst, 2);
 
-				int index_getter = _code_ptr[ip + 4];
+				int index_getter = CODE(ip + 4);
 				GD_ERR_BREAK(index_getter < 0 || index_getter >= _keyed_getters_count);
 				const RuztaVariantExtension::ValidatedKeyedGetter getter = _keyed_getters_ptr[index_getter];
 
@@ -1150,60 +1902,164 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 					if (!v.is_empty()) {
 						v = "'" + v + "'";
 					} else {
-						v = "of type '" + _get_var_type(key) + "'";
+						v = "of type '" + _get_var_type(key) + "'";
+					}
+					err_text = "Invalid access to property or key " + v + " on a base object of type '" + _get_var_type(src) + "'.";
+					OPCODE_BREAK;
+				}
+				*dst = ret;
+#endif
+				ip += 5;
+			}
+			DISPATCH_OPCODE;
+
+			OPCODE(OPCODE_GET_INDEXED_VALIDATED) {
+				CHECK_SPACE(4);
+
+				GET_VARIANT_PTR(src, 0);
+				GET_VARIANT_PTR(index, 1);
+				GET_VARIANT_PTR(dst, 2);
+
+				int index_getter = CODE(ip + 4);
+				GD_ERR_BREAK(index_getter < 0 || index_getter >= _indexed_getters_count);
+				const RuztaVariantExtension::ValidatedIndexedGetter getter = _indexed_getters_ptr[index_getter];
+
+				int64_t int_index = *VariantInternal::get_int(index);
+
+				bool oob;
+				getter(src, int_index, dst, &oob);
+
+#ifdef DEBUG_ENABLED
+				if (oob) {
+					String v = index->operator String();
+					if (!v.is_empty()) {
+						v = "'" + v + "'";
+					} else {
+						v = "of type '" + _get_var_type(index) + "'";
 					}
-					err_text = "Invalid access to property or key " + v + " on a base object of type '" + _get_var_type(src) + "'.";
+					err_text = "Out of bounds get index " + v + " (on base: '" + _get_var_type(src) + "')";
 					OPCODE_BREAK;
 				}
-				*dst = ret;
 #endif
 				ip += 5;
 			}
 			DISPATCH_OPCODE;
 
-			OPCODE(OPCODE_GET_INDEXED_VALIDATED) {
-				CHECK_SPACE(4);
+			OPCODE(OPCODE_GET_KEYED_QUICKENED) {
+				CHECK_SPACE(5);
+
+				int site_cache_idx = CODE(ip + 4);
+				GD_ERR_BREAK(site_cache_idx < 0 || site_cache_idx >= _site_caches_count);
+				SiteCache *site_cache = &_site_caches_ptr[site_cache_idx];
 
 				GET_VARIANT_PTR(src, 0);
 				GET_VARIANT_PTR(index, 1);
 				GET_VARIANT_PTR(dst, 2);
 
-				int index_getter = _code_ptr[ip + 4];
-				GD_ERR_BREAK(index_getter < 0 || index_getter >= _indexed_getters_count);
-				const RuztaVariantExtension::ValidatedIndexedGetter getter = _indexed_getters_ptr[index_getter];
-
-				int64_t int_index = *VariantInternal::get_int(index);
-
-				bool oob;
-				getter(src, int_index, dst, &oob);
+				int cache = site_cache->signature;
+				if (unlikely(_quicken_keyed_signature(cache, src, index, nullptr) != cache)) {
+					// Types changed, fall back to the generic form.
+					_quicken_deopt(&site_cache->counter);
+					REWRITE_OPCODE(OPCODE_GET_KEYED);
+					DISPATCH_OPCODE;
+				}
 
+				bool valid;
 #ifdef DEBUG_ENABLED
-				if (oob) {
+				// Allow better error message in cases where src and dst are the same stack position.
+				Variant ret;
+				Variant *result = &ret;
+#else
+				Variant *result = dst;
+#endif
+				if (cache & QUICKEN_INDEXED) {
+					const RuztaVariantExtension::ValidatedIndexedGetter getter = reinterpret_cast<RuztaVariantExtension::ValidatedIndexedGetter>(site_cache->function);
+					bool oob;
+					getter(src, *VariantInternal::get_int(index), result, &oob);
+					valid = !oob;
+				} else {
+					const RuztaVariantExtension::ValidatedKeyedGetter getter = reinterpret_cast<RuztaVariantExtension::ValidatedKeyedGetter>(site_cache->function);
+					getter(src, index, result, &valid);
+				}
+#ifdef DEBUG_ENABLED
+				if (!valid) {
 					String v = index->operator String();
 					if (!v.is_empty()) {
 						v = "'" + v + "'";
 					} else {
 						v = "of type '" + _get_var_type(index) + "'";
 					}
-					err_text = "Out of bounds get index " + v + " (on base: '" + _get_var_type(src) + "')";
+					if (cache & QUICKEN_INDEXED) {
+						err_text = "Out of bounds get index " + v + " (on base: '" + _get_var_type(src) + "')";
+					} else {
+						err_text = "Invalid access to property or key " + v + " on a base object of type '" + _get_var_type(src) + "'.";
+					}
 					OPCODE_BREAK;
 				}
+				*dst = ret;
 #endif
 				ip += 5;
 			}
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_SET_NAMED) {
-				CHECK_SPACE(3);
+				CHECK_SPACE(6);
+
+				int site_cache_idx = CODE(ip + 4);
+				GD_ERR_BREAK(site_cache_idx < 0 || site_cache_idx >= _site_caches_count);
+				SiteCache *site_cache = &_site_caches_ptr[site_cache_idx];
 
 				GET_VARIANT_PTR(dst, 0);
 				GET_VARIANT_PTR(value, 1);
 
-				int indexname = _code_ptr[ip + 3];
+				int indexname = CODE(ip + 3);
 
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
+				if (dst->get_type() == Variant::OBJECT) {
+					// Members of Ruzta instances are written straight to their slot.
+					Object *obj = dst->get_validated_object();
+					RuztaInstance *instance = obj ? static_cast<RuztaInstance *>(godot::internal::gdextension_interface_object_get_script_instance(obj, RuztaLanguage::get_singleton())) : nullptr;
+					if (instance) {
+						int cache_index = CODE(ip + 5);
+						GD_ERR_BREAK(cache_index < 0 || cache_index >= _member_caches_count);
+						const MemberCache::Entry *entry = _get_member_cache_entry(&_member_caches_ptr[cache_index], instance, *index, true);
+						if (entry && (entry->type == Variant::VARIANT_MAX || entry->type == value->get_type()) && entry->index < instance->members.size()) {
+							instance->members.write[entry->index] = *value;
+							ip += 6;
+							DISPATCH_OPCODE;
+						}
+					}
+				}
+
+				int actual_signature = (dst->get_type() << 8) | value->get_type();
+
+				// Check if this is the first run. If so, resolve a validated setter for the current types.
+				if (unlikely(site_cache->signature == 0) && dst->get_type() != Variant::NIL) {
+					static Mutex initializer_mutex;
+					initializer_mutex.lock();
+					if (site_cache->signature == 0) {
+						Variant::Type base_type = dst->get_type();
+						RuztaVariantExtension::ValidatedSetter setter = RuztaVariantExtension::get_member_validated_setter(base_type, *index);
+						if (setter && RuztaVariantExtension::get_member_type(base_type, *index) == value->get_type()) {
+							site_cache->function = reinterpret_cast<SiteCache::Function>(setter);
+							site_cache->signature = actual_signature;
+						} else {
+							site_cache->signature = QUICKEN_SIGNATURE_NONE;
+						}
+					}
+					initializer_mutex.unlock();
+				}
+
+				if (site_cache->signature > 0 && site_cache->signature == actual_signature) {
+					if (unlikely(_quicken_hit(&site_cache->counter))) {
+						REWRITE_OPCODE(OPCODE_SET_NAMED_QUICKENED);
+					}
+				} else {
+					_quicken_miss(&site_cache->counter);
+				}
+
 				bool valid;
 				dst->set_named(*index, *value, valid);
 
@@ -1226,7 +2082,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 					OPCODE_BREAK;
 				}
 #endif
-				ip += 4;
+				ip += 6;
 			}
 			DISPATCH_OPCODE;
 
@@ -1236,7 +2092,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				GET_VARIANT_PTR(dst, 0);
 				GET_VARIANT_PTR(value, 1);
 
-				int index_setter = _code_ptr[ip + 3];
+				int index_setter = CODE(ip + 3);
 				GD_ERR_BREAK(index_setter < 0 || index_setter >= _setters_count);
 				const RuztaVariantExtension::ValidatedSetter setter = _setters_ptr[index_setter];
 
@@ -1245,17 +2101,84 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_SET_NAMED_QUICKENED) {
+				CHECK_SPACE(6);
+
+				int site_cache_idx = CODE(ip + 4);
+				GD_ERR_BREAK(site_cache_idx < 0 || site_cache_idx >= _site_caches_count);
+				SiteCache *site_cache = &_site_caches_ptr[site_cache_idx];
+
+				GET_VARIANT_PTR(dst, 0);
+				GET_VARIANT_PTR(value, 1);
+
+				if (unlikely(site_cache->signature != ((dst->get_type() << 8) | value->get_type()))) {
+					// Types changed, fall back to the generic form.
+					_quicken_deopt(&site_cache->counter);
+					REWRITE_OPCODE(OPCODE_SET_NAMED);
+					DISPATCH_OPCODE;
+				}
+
+				const RuztaVariantExtension::ValidatedSetter setter = reinterpret_cast<RuztaVariantExtension::ValidatedSetter>(site_cache->function);
+				setter(dst, value);
+				ip += 6;
+			}
+			DISPATCH_OPCODE;
+
 			OPCODE(OPCODE_GET_NAMED) {
-				CHECK_SPACE(4);
+				CHECK_SPACE(6);
+
+				int site_cache_idx = CODE(ip + 4);
+				GD_ERR_BREAK(site_cache_idx < 0 || site_cache_idx >= _site_caches_count);
+				SiteCache *site_cache = &_site_caches_ptr[site_cache_idx];
 
 				GET_VARIANT_PTR(src, 0);
 				GET_VARIANT_PTR(dst, 1);
 
-				int indexname = _code_ptr[ip + 3];
+				int indexname = CODE(ip + 3);
 
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
+				if (src->get_type() == Variant::OBJECT) {
+					// Members of Ruzta instances are read straight from their slot.
+					Object *obj = src->get_validated_object();
+					const RuztaInstance *instance = obj ? static_cast<RuztaInstance *>(godot::internal::gdextension_interface_object_get_script_instance(obj, RuztaLanguage::get_singleton())) : nullptr;
+					if (instance) {
+						int cache_index = CODE(ip + 5);
+						GD_ERR_BREAK(cache_index < 0 || cache_index >= _member_caches_count);
+						const MemberCache::Entry *entry = _get_member_cache_entry(&_member_caches_ptr[cache_index], instance, *index, false);
+						if (entry && entry->index < instance->members.size()) {
+							*dst = instance->members[entry->index];
+							ip += 6;
+							DISPATCH_OPCODE;
+						}
+					}
+				}
+
+				// Check if this is the first run. If so, resolve a validated getter for the current type.
+				if (unlikely(site_cache->signature == 0) && src->get_type() != Variant::NIL) {
+					static Mutex initializer_mutex;
+					initializer_mutex.lock();
+					if (site_cache->signature == 0) {
+						RuztaVariantExtension::ValidatedGetter getter = RuztaVariantExtension::get_member_validated_getter(src->get_type(), *index);
+						if (getter) {
+							site_cache->function = reinterpret_cast<SiteCache::Function>(getter);
+							site_cache->signature = src->get_type();
+						} else {
+							site_cache->signature = QUICKEN_SIGNATURE_NONE;
+						}
+					}
+					initializer_mutex.unlock();
+				}
+
+				if (site_cache->signature > 0 && site_cache->signature == src->get_type()) {
+					if (unlikely(_quicken_hit(&site_cache->counter))) {
+						REWRITE_OPCODE(OPCODE_GET_NAMED_QUICKENED);
+					}
+				} else {
+					_quicken_miss(&site_cache->counter);
+				}
+
 				bool valid;
 #ifdef DEBUG_ENABLED
 				//allow better error message in cases where src and dst are the same stack position
@@ -1271,7 +2194,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				}
 				*dst = ret;
 #endif
-				ip += 4;
+				ip += 6;
 			}
 			DISPATCH_OPCODE;
 
@@ -1281,7 +2204,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				GET_VARIANT_PTR(src, 0);
 				GET_VARIANT_PTR(dst, 1);
 
-				int index_getter = _code_ptr[ip + 3];
+				int index_getter = CODE(ip + 3);
 				GD_ERR_BREAK(index_getter < 0 || index_getter >= _getters_count);
 				const RuztaVariantExtension::ValidatedGetter getter = _getters_ptr[index_getter];
 
@@ -1290,10 +2213,33 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_GET_NAMED_QUICKENED) {
+				CHECK_SPACE(6);
+
+				int site_cache_idx = CODE(ip + 4);
+				GD_ERR_BREAK(site_cache_idx < 0 || site_cache_idx >= _site_caches_count);
+				SiteCache *site_cache = &_site_caches_ptr[site_cache_idx];
+
+				GET_VARIANT_PTR(src, 0);
+				GET_VARIANT_PTR(dst, 1);
+
+				if (unlikely(site_cache->signature != src->get_type())) {
+					// Types changed, fall back to the generic form.
+					_quicken_deopt(&site_cache->counter);
+					REWRITE_OPCODE(OPCODE_GET_NAMED);
+					DISPATCH_OPCODE;
+				}
+
+				const RuztaVariantExtension::ValidatedGetter getter = reinterpret_cast<RuztaVariantExtension::ValidatedGetter>(site_cache->function);
+				getter(src, dst);
+				ip += 6;
+			}
+			DISPATCH_OPCODE;
+
 			OPCODE(OPCODE_SET_MEMBER) {
 				CHECK_SPACE(3);
 				GET_VARIANT_PTR(src, 0);
-				int indexname = _code_ptr[ip + 2];
+				int indexname = CODE(ip + 2);
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
@@ -1317,18 +2263,9 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 			OPCODE(OPCODE_GET_MEMBER) {
 				CHECK_SPACE(3);
 				GET_VARIANT_PTR(dst, 0);
-				int indexname = _code_ptr[ip + 2];
+				int indexname = CODE(ip + 2);
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
-				const StringName *index = &_global_names_ptr[indexname];
-#ifndef DEBUG_ENABLED
-				ClassDB::get_property(p_instance->owner, *index, *dst);
-#else
-				bool ok = ClassDB::get_property(p_instance->owner, *index, *dst);
-				if (!ok) {
-					err_text = "Internal error getting property: " + String(*index);
-					OPCODE_BREAK;
-				}
-#endif
+				GET_MEMBER_PROPERTY(dst, _global_names_ptr[indexname]);
 				ip += 3;
 			}
 			DISPATCH_OPCODE;
@@ -1342,7 +2279,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				Ruzta *ruzta = Object::cast_to<Ruzta>(_class->operator Object *());
 				GD_ERR_BREAK(!ruzta);
 
-				int index = _code_ptr[ip + 3];
+				int index = CODE(ip + 3);
 				GD_ERR_BREAK(index < 0 || index >= ruzta->static_variables.size());
 
 				ruzta->static_variables.write[index] = *value;
@@ -1360,7 +2297,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				Ruzta *ruzta = Object::cast_to<Ruzta>(_class->operator Object *());
 				GD_ERR_BREAK(!ruzta);
 
-				int index = _code_ptr[ip + 3];
+				int index = CODE(ip + 3);
 				GD_ERR_BREAK(index < 0 || index >= ruzta->static_variables.size());
 
 				*target = ruzta->static_variables[index];
@@ -1415,7 +2352,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				GET_VARIANT_PTR(dst, 0);
 				GET_VARIANT_PTR(src, 1);
 
-				Variant::Type var_type = (Variant::Type)_code_ptr[ip + 3];
+				Variant::Type var_type = (Variant::Type)CODE(ip + 3);
 				GD_ERR_BREAK(var_type < 0 || var_type >= Variant::VARIANT_MAX);
 
 				if (src->get_type() != var_type) {
@@ -1445,8 +2382,8 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				GET_VARIANT_PTR(src, 1);
 
 				GET_VARIANT_PTR(script_type, 2);
-				Variant::Type builtin_type = (Variant::Type)_code_ptr[ip + 4];
-				int native_type_idx = _code_ptr[ip + 5];
+				Variant::Type builtin_type = (Variant::Type)CODE(ip + 4);
+				int native_type_idx = CODE(ip + 5);
 				GD_ERR_BREAK(native_type_idx < 0 || native_type_idx >= _global_names_count);
 				const StringName native_type = _global_names_ptr[native_type_idx];
 
@@ -1480,14 +2417,14 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				GET_VARIANT_PTR(src, 1);
 
 				GET_VARIANT_PTR(key_script_type, 2);
-				Variant::Type key_builtin_type = (Variant::Type)_code_ptr[ip + 5];
-				int key_native_type_idx = _code_ptr[ip + 6];
+				Variant::Type key_builtin_type = (Variant::Type)CODE(ip + 5);
+				int key_native_type_idx = CODE(ip + 6);
 				GD_ERR_BREAK(key_native_type_idx < 0 || key_native_type_idx >= _global_names_count);
 				const StringName key_native_type = _global_names_ptr[key_native_type_idx];
 
 				GET_VARIANT_PTR(value_script_type, 3);
-				Variant::Type value_builtin_type = (Variant::Type)_code_ptr[ip + 7];
-				int value_native_type_idx = _code_ptr[ip + 8];
+				Variant::Type value_builtin_type = (Variant::Type)CODE(ip + 7);
+				int value_native_type_idx = CODE(ip + 8);
 				GD_ERR_BREAK(value_native_type_idx < 0 || value_native_type_idx >= _global_names_count);
 				const StringName value_native_type = _global_names_ptr[value_native_type_idx];
 
@@ -1614,7 +2551,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				CHECK_SPACE(4);
 				GET_VARIANT_PTR(src, 0);
 				GET_VARIANT_PTR(dst, 1);
-				Variant::Type to_type = (Variant::Type)_code_ptr[ip + 3];
+				Variant::Type to_type = (Variant::Type)CODE(ip + 3);
 
 				GD_ERR_BREAK(to_type < 0 || to_type >= Variant::VARIANT_MAX);
 
@@ -1725,9 +2662,9 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 
 				ip += instr_arg_count;
 
-				int argc = _code_ptr[ip + 1];
+				int argc = CODE(ip + 1);
 
-				Variant::Type t = Variant::Type(_code_ptr[ip + 2]);
+				Variant::Type t = Variant::Type(CODE(ip + 2));
 
 				Variant **argptrs = instruction_args;
 
@@ -1752,9 +2689,9 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				CHECK_SPACE(2 + instr_arg_count);
 				ip += instr_arg_count;
 
-				int argc = _code_ptr[ip + 1];
+				int argc = CODE(ip + 1);
 
-				int constructor_idx = _code_ptr[ip + 2];
+				int constructor_idx = CODE(ip + 2);
 				GD_ERR_BREAK(constructor_idx < 0 || constructor_idx >= _constructors_count);
 				RuztaVariantExtension::ValidatedConstructor constructor = _constructors_ptr[constructor_idx];
 
@@ -1773,7 +2710,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				CHECK_SPACE(1 + instr_arg_count);
 				ip += instr_arg_count;
 
-				int argc = _code_ptr[ip + 1];
+				int argc = CODE(ip + 1);
 				Array array;
 				array.resize(argc);
 
@@ -1795,11 +2732,11 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				CHECK_SPACE(3 + instr_arg_count);
 				ip += instr_arg_count;
 
-				int argc = _code_ptr[ip + 1];
+				int argc = CODE(ip + 1);
 
 				GET_INSTRUCTION_ARG(script_type, argc + 1);
-				Variant::Type builtin_type = (Variant::Type)_code_ptr[ip + 2];
-				int native_type_idx = _code_ptr[ip + 3];
+				Variant::Type builtin_type = (Variant::Type)CODE(ip + 2);
+				int native_type_idx = CODE(ip + 3);
 				GD_ERR_BREAK(native_type_idx < 0 || native_type_idx >= _global_names_count);
 				const StringName native_type = _global_names_ptr[native_type_idx];
 
@@ -1826,7 +2763,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 
 				ip += instr_arg_count;
 
-				int argc = _code_ptr[ip + 1];
+				int argc = CODE(ip + 1);
 				Dictionary dict;
 				dict.reserve(argc);
 				for (int i = 0; i < argc; i++) {
@@ -1850,17 +2787,17 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				CHECK_SPACE(6 + instr_arg_count);
 				ip += instr_arg_count;
 
-				int argc = _code_ptr[ip + 1];
+				int argc = CODE(ip + 1);
 
 				GET_INSTRUCTION_ARG(key_script_type, argc * 2 + 1);
-				Variant::Type key_builtin_type = (Variant::Type)_code_ptr[ip + 2];
-				int key_native_type_idx = _code_ptr[ip + 3];
+				Variant::Type key_builtin_type = (Variant::Type)CODE(ip + 2);
+				int key_native_type_idx = CODE(ip + 3);
 				GD_ERR_BREAK(key_native_type_idx < 0 || key_native_type_idx >= _global_names_count);
 				const StringName key_native_type = _global_names_ptr[key_native_type_idx];
 
 				GET_INSTRUCTION_ARG(value_script_type, argc * 2 + 2);
-				Variant::Type value_builtin_type = (Variant::Type)_code_ptr[ip + 4];
-				int value_native_type_idx = _code_ptr[ip + 5];
+				Variant::Type value_builtin_type = (Variant::Type)CODE(ip + 4);
+				int value_native_type_idx = CODE(ip + 5);
 				GD_ERR_BREAK(value_native_type_idx < 0 || value_native_type_idx >= _global_names_count);
 				const StringName value_native_type = _global_names_ptr[value_native_type_idx];
 
@@ -1887,19 +2824,19 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 			OPCODE(OPCODE_CALL_ASYNC)
 			OPCODE(OPCODE_CALL_RETURN)
 			OPCODE(OPCODE_CALL) {
-				bool call_ret = (_code_ptr[ip]) != OPCODE_CALL;
+				bool call_ret = (CODE(ip)) != OPCODE_CALL;
 #ifdef DEBUG_ENABLED
-				bool call_async = (_code_ptr[ip]) == OPCODE_CALL_ASYNC;
+				bool call_async = (CODE(ip)) == OPCODE_CALL_ASYNC;
 #endif
 				LOAD_INSTRUCTION_ARGS
-				CHECK_SPACE(3 + instr_arg_count);
+				CHECK_SPACE(4 + instr_arg_count);
 
 				ip += instr_arg_count;
 
-				int argc = _code_ptr[ip + 1];
+				int argc = CODE(ip + 1);
 				GD_ERR_BREAK(argc < 0);
 
-				int methodname_idx = _code_ptr[ip + 2];
+				int methodname_idx = CODE(ip + 2);
 				GD_ERR_BREAK(methodname_idx < 0 || methodname_idx >= _global_names_count);
 				const StringName *methodname = &_global_names_ptr[methodname_idx];
 
@@ -1917,11 +2854,37 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				StringName base_class = base_obj ? base_obj->get_class() : StringName();
 #endif
 
+				// Script functions of Ruzta receivers, and method binds of native receivers without a script,
+				// are called directly through the call site cache.
+				RuztaInstance *base_instance = nullptr;
+				RuztaFunction *cached_function = nullptr;
+				Object *native_obj = nullptr;
+				MethodBind *cached_method = nullptr;
+				if (base->get_type() == Variant::OBJECT) {
+					Object *obj = base->get_validated_object();
+					base_instance = obj ? static_cast<RuztaInstance *>(godot::internal::gdextension_interface_object_get_script_instance(obj, RuztaLanguage::get_singleton())) : nullptr;
+					int cache_index = CODE(ip + 3);
+					GD_ERR_BREAK(cache_index < 0 || cache_index >= _call_caches_count);
+					if (base_instance) {
+						cached_function = _get_call_cache_function(&_call_caches_ptr[cache_index], base_instance, *methodname);
+					} else if (obj && obj->get_script().get_type() == Variant::NIL) {
+						// Scripts of other languages may define the method, only plain native objects are cached.
+						native_obj = obj;
+						cached_method = _get_call_cache_method(&_call_caches_ptr[cache_index], obj, *methodname);
+					}
+				}
+
 				Variant temp_ret;
 				GDExtensionCallError err;
 				if (call_ret) {
 					GET_INSTRUCTION_ARG(ret, argc + 1);
-					base->callp(*methodname, (const Variant **)argptrs, argc, temp_ret, err);
+					if (cached_function) {
+						temp_ret = cached_function->call(base_instance, (const Variant **)argptrs, argc, err, nullptr, false, STABLE_ARGUMENTS(ip - instr_arg_count + 1, argc));
+					} else if (cached_method) {
+						temp_ret = cached_method->call(native_obj, (const Variant **)argptrs, argc, err);
+					} else {
+						base->callp(*methodname, (const Variant **)argptrs, argc, temp_ret, err);
+					}
 					*ret = temp_ret;
 #ifdef DEBUG_ENABLED
 					if (ret->get_type() == Variant::NIL) {
@@ -1949,6 +2912,10 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 						}
 					}
 #endif
+				} else if (cached_function) {
+					temp_ret = cached_function->call(base_instance, (const Variant **)argptrs, argc, err, nullptr, false, STABLE_ARGUMENTS(ip - instr_arg_count + 1, argc));
+				} else if (cached_method) {
+					temp_ret = cached_method->call(native_obj, (const Variant **)argptrs, argc, err);
 				} else {
 					base->callp(*methodname, (const Variant **)argptrs, argc, temp_ret, err);
 				}
@@ -2005,22 +2972,22 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				}
 #endif // DEBUG_ENABLED
 
-				ip += 3;
+				ip += 4;
 			}
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_CALL_METHOD_BIND)
 			OPCODE(OPCODE_CALL_METHOD_BIND_RET) {
-				bool call_ret = (_code_ptr[ip]) == OPCODE_CALL_METHOD_BIND_RET;
+				bool call_ret = (CODE(ip)) == OPCODE_CALL_METHOD_BIND_RET;
 				LOAD_INSTRUCTION_ARGS
 				CHECK_SPACE(3 + instr_arg_count);
 
 				ip += instr_arg_count;
 
-				int argc = _code_ptr[ip + 1];
+				int argc = CODE(ip + 1);
 				GD_ERR_BREAK(argc < 0);
-				GD_ERR_BREAK(_code_ptr[ip + 2] < 0 || _code_ptr[ip + 2] >= _methods_count);
-				MethodBind *method = _methods_ptr[_code_ptr[ip + 2]];
+				GD_ERR_BREAK(CODE(ip + 2) < 0 || CODE(ip + 2) >= _methods_count);
+				MethodBind *method = _methods_ptr[CODE(ip + 2)];
 
 				GET_INSTRUCTION_ARG(base, argc);
 
@@ -2099,14 +3066,14 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 
 				ip += instr_arg_count;
 
-				GD_ERR_BREAK(_code_ptr[ip + 1] < 0 || _code_ptr[ip + 1] >= Variant::VARIANT_MAX);
-				Variant::Type builtin_type = (Variant::Type)_code_ptr[ip + 1];
+				GD_ERR_BREAK(CODE(ip + 1) < 0 || CODE(ip + 1) >= Variant::VARIANT_MAX);
+				Variant::Type builtin_type = (Variant::Type)CODE(ip + 1);
 
-				int methodname_idx = _code_ptr[ip + 2];
+				int methodname_idx = CODE(ip + 2);
 				GD_ERR_BREAK(methodname_idx < 0 || methodname_idx >= _global_names_count);
 				const StringName *methodname = &_global_names_ptr[methodname_idx];
 
-				int argc = _code_ptr[ip + 3];
+				int argc = CODE(ip + 3);
 				GD_ERR_BREAK(argc < 0);
 
 				GET_INSTRUCTION_ARG(ret, argc);
@@ -2133,10 +3100,10 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 
 				ip += instr_arg_count;
 
-				GD_ERR_BREAK(_code_ptr[ip + 1] < 0 || _code_ptr[ip + 1] >= _methods_count);
-				MethodBind *method = _methods_ptr[_code_ptr[ip + 1]];
+				GD_ERR_BREAK(CODE(ip + 1) < 0 || CODE(ip + 1) >= _methods_count);
+				MethodBind *method = _methods_ptr[CODE(ip + 1)];
 
-				int argc = _code_ptr[ip + 2];
+				int argc = CODE(ip + 2);
 				GD_ERR_BREAK(argc < 0);
 
 				GET_INSTRUCTION_ARG(ret, argc);
@@ -2176,11 +3143,11 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 
 				ip += instr_arg_count;
 
-				int argc = _code_ptr[ip + 1];
+				int argc = CODE(ip + 1);
 				GD_ERR_BREAK(argc < 0);
 
-				GD_ERR_BREAK(_code_ptr[ip + 2] < 0 || _code_ptr[ip + 2] >= _methods_count);
-				MethodBind *method = _methods_ptr[_code_ptr[ip + 2]];
+				GD_ERR_BREAK(CODE(ip + 2) < 0 || CODE(ip + 2) >= _methods_count);
+				MethodBind *method = _methods_ptr[CODE(ip + 2)];
 
 				Variant **argptrs = instruction_args;
 
@@ -2212,11 +3179,11 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 
 				ip += instr_arg_count;
 
-				int argc = _code_ptr[ip + 1];
+				int argc = CODE(ip + 1);
 				GD_ERR_BREAK(argc < 0);
 
-				GD_ERR_BREAK(_code_ptr[ip + 2] < 0 || _code_ptr[ip + 2] >= _methods_count);
-				MethodBind *method = _methods_ptr[_code_ptr[ip + 2]];
+				GD_ERR_BREAK(CODE(ip + 2) < 0 || CODE(ip + 2) >= _methods_count);
+				MethodBind *method = _methods_ptr[CODE(ip + 2)];
 
 				Variant **argptrs = instruction_args;
 #ifdef DEBUG_ENABLED
@@ -2242,17 +3209,26 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 			}
 			DISPATCH_OPCODE;
 
+			// Superinstructions run the GET_MEMBER at their position, then fall through to the call right after it.
+			OPCODE(OPCODE_GET_MEMBER_CALL_VALIDATED_RETURN) {
+				CHECK_SPACE(3);
+				GET_VARIANT_PTR(dst, 0);
+				int indexname = CODE(ip + 2);
+				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
+				GET_MEMBER_PROPERTY(dst, _global_names_ptr[indexname]);
+				ip += 3;
+			}
 			OPCODE(OPCODE_CALL_METHOD_BIND_VALIDATED_RETURN) {
 				LOAD_INSTRUCTION_ARGS
 				CHECK_SPACE(3 + instr_arg_count);
 
 				ip += instr_arg_count;
 
-				int argc = _code_ptr[ip + 1];
+				int argc = CODE(ip + 1);
 				GD_ERR_BREAK(argc < 0);
 
-				GD_ERR_BREAK(_code_ptr[ip + 2] < 0 || _code_ptr[ip + 2] >= _methods_count);
-				MethodBind *method = _methods_ptr[_code_ptr[ip + 2]];
+				GD_ERR_BREAK(CODE(ip + 2) < 0 || CODE(ip + 2) >= _methods_count);
+				MethodBind *method = _methods_ptr[CODE(ip + 2)];
 
 				GET_INSTRUCTION_ARG(base, argc);
 
@@ -2293,17 +3269,25 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_GET_MEMBER_CALL_VALIDATED_NO_RETURN) {
+				CHECK_SPACE(3);
+				GET_VARIANT_PTR(dst, 0);
+				int indexname = CODE(ip + 2);
+				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
+				GET_MEMBER_PROPERTY(dst, _global_names_ptr[indexname]);
+				ip += 3;
+			}
 			OPCODE(OPCODE_CALL_METHOD_BIND_VALIDATED_NO_RETURN) {
 				LOAD_INSTRUCTION_ARGS
 				CHECK_SPACE(3 + instr_arg_count);
 
 				ip += instr_arg_count;
 
-				int argc = _code_ptr[ip + 1];
+				int argc = CODE(ip + 1);
 				GD_ERR_BREAK(argc < 0);
 
-				GD_ERR_BREAK(_code_ptr[ip + 2] < 0 || _code_ptr[ip + 2] >= _methods_count);
-				MethodBind *method = _methods_ptr[_code_ptr[ip + 2]];
+				GD_ERR_BREAK(CODE(ip + 2) < 0 || CODE(ip + 2) >= _methods_count);
+				MethodBind *method = _methods_ptr[CODE(ip + 2)];
 
 				GET_INSTRUCTION_ARG(base, argc);
 #ifdef DEBUG_ENABLED
@@ -2349,13 +3333,13 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 
 				ip += instr_arg_count;
 
-				int argc = _code_ptr[ip + 1];
+				int argc = CODE(ip + 1);
 				GD_ERR_BREAK(argc < 0);
 
 				GET_INSTRUCTION_ARG(base, argc);
 
-				GD_ERR_BREAK(_code_ptr[ip + 2] < 0 || _code_ptr[ip + 2] >= _builtin_methods_count);
-				RuztaVariantExtension::ValidatedBuiltInMethod method = _builtin_methods_ptr[_code_ptr[ip + 2]];
+				GD_ERR_BREAK(CODE(ip + 2) < 0 || CODE(ip + 2) >= _builtin_methods_count);
+				RuztaVariantExtension::ValidatedBuiltInMethod method = _builtin_methods_ptr[CODE(ip + 2)];
 				Variant **argptrs = instruction_args;
 
 				GET_INSTRUCTION_ARG(ret, argc + 1);
@@ -2371,11 +3355,11 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 
 				ip += instr_arg_count;
 
-				int argc = _code_ptr[ip + 1];
+				int argc = CODE(ip + 1);
 				GD_ERR_BREAK(argc < 0);
 
-				GD_ERR_BREAK(_code_ptr[ip + 2] < 0 || _code_ptr[ip + 2] >= _global_names_count);
-				StringName function = _global_names_ptr[_code_ptr[ip + 2]];
+				GD_ERR_BREAK(CODE(ip + 2) < 0 || CODE(ip + 2) >= _global_names_count);
+				StringName function = _global_names_ptr[CODE(ip + 2)];
 
 				Variant **argptrs = instruction_args;
 
@@ -2406,11 +3390,11 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 
 				ip += instr_arg_count;
 
-				int argc = _code_ptr[ip + 1];
+				int argc = CODE(ip + 1);
 				GD_ERR_BREAK(argc < 0);
 
-				GD_ERR_BREAK(_code_ptr[ip + 2] < 0 || _code_ptr[ip + 2] >= _utilities_count);
-				RuztaVariantExtension::ValidatedUtilityFunction function = _utilities_ptr[_code_ptr[ip + 2]];
+				GD_ERR_BREAK(CODE(ip + 2) < 0 || CODE(ip + 2) >= _utilities_count);
+				RuztaVariantExtension::ValidatedUtilityFunction function = _utilities_ptr[CODE(ip + 2)];
 
 				Variant **argptrs = instruction_args;
 
@@ -2428,11 +3412,11 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 
 				ip += instr_arg_count;
 
-				int argc = _code_ptr[ip + 1];
+				int argc = CODE(ip + 1);
 				GD_ERR_BREAK(argc < 0);
 
-				GD_ERR_BREAK(_code_ptr[ip + 2] < 0 || _code_ptr[ip + 2] >= _gds_utilities_count);
-				RuztaUtilityFunctions::FunctionPtr function = _gds_utilities_ptr[_code_ptr[ip + 2]];
+				GD_ERR_BREAK(CODE(ip + 2) < 0 || CODE(ip + 2) >= _gds_utilities_count);
+				RuztaUtilityFunctions::FunctionPtr function = _gds_utilities_ptr[CODE(ip + 2)];
 
 				Variant **argptrs = instruction_args;
 
@@ -2443,7 +3427,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 
 #ifdef DEBUG_ENABLED
 				if (err.error != GDExtensionCallErrorType::GDEXTENSION_CALL_OK) {
-					String methodstr = gds_utilities_names[_code_ptr[ip + 2]];
+					String methodstr = gds_utilities_names[CODE(ip + 2)];
 					if (dst->get_type() == Variant::STRING && !dst->operator String().is_empty()) {
 						// Call provided error string.
 						err_text = vformat(R"*(Error calling Ruzta utility function "%s()": %s)*", methodstr, *dst);
@@ -2463,10 +3447,10 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 
 				ip += instr_arg_count;
 
-				int argc = _code_ptr[ip + 1];
+				int argc = CODE(ip + 1);
 				GD_ERR_BREAK(argc < 0);
 
-				int self_fun = _code_ptr[ip + 2];
+				int self_fun = CODE(ip + 2);
 #ifdef DEBUG_ENABLED
 				if (self_fun < 0 || self_fun >= _global_names_count) {
 					err_text = "compiler bug, function name not found";
@@ -2493,7 +3477,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				GDExtensionCallError err;
 
 				if (E) {
-					*dst = E->value->call(p_instance, (const Variant **)argptrs, argc, err);
+					*dst = E->value->call(p_instance, (const Variant **)argptrs, argc, err, nullptr, false, STABLE_ARGUMENTS(ip - instr_arg_count + 1, argc));
 				} else if (gds->native.ptr()) {
 					if (*methodname != RuztaLanguage::get_singleton()->strings._init) {
 						MethodBind *mb = ClassDB::get_method(gds->native->get_name(), *methodname);
@@ -2524,10 +3508,59 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_CALL_DIRECT_VALIDATED)
+			OPCODE(OPCODE_CALL_DIRECT) {
+				bool validated = (CODE(ip)) == OPCODE_CALL_DIRECT_VALIDATED;
+				LOAD_INSTRUCTION_ARGS
+				CHECK_SPACE(3 + instr_arg_count);
+
+				ip += instr_arg_count;
+
+				int argc = CODE(ip + 1);
+				GD_ERR_BREAK(argc < 0);
+
+				int direct_call_idx = CODE(ip + 2);
+				GD_ERR_BREAK(direct_call_idx < 0 || direct_call_idx >= _direct_calls_count);
+				const DirectCall *direct_call = &_direct_calls_ptr[direct_call_idx];
+
+				Variant **argptrs = instruction_args;
+
+				GET_INSTRUCTION_ARG(dst, argc);
+
+				// The callee can't be overridden, so it's the same for every receiver.
+				RuztaFunction *callee = direct_call->function ? (RuztaFunction *)*direct_call->function : nullptr;
+				if (unlikely(!callee)) {
+					// Removed by a reload of the script, look it up again. The new function may take other types.
+					HashMap<StringName, RuztaFunction *>::ConstIterator E = _script->method_table.find(direct_call->name);
+					if (E) {
+						callee = E->value;
+					}
+					validated = false;
+				}
+
+				GDExtensionCallError err;
+				if (likely(callee)) {
+					// Arguments go straight into the callee's frame, and the return value is moved into `dst`.
+					*dst = callee->call(callee->_static ? nullptr : p_instance, (const Variant **)argptrs, argc, err, nullptr, validated, STABLE_ARGUMENTS(ip - instr_arg_count + 1, argc));
+				} else {
+					err.error = GDExtensionCallErrorType::GDEXTENSION_CALL_ERROR_INVALID_METHOD;
+				}
+
+				if (err.error != GDExtensionCallErrorType::GDEXTENSION_CALL_OK) {
+					String methodstr = direct_call->name;
+					err_text = _get_call_error("function '" + methodstr + "'", (const Variant **)argptrs, argc, *dst, err);
+
+					OPCODE_BREAK;
+				}
+
+				ip += 3;
+			}
+			DISPATCH_OPCODE;
+
 			OPCODE(OPCODE_AWAIT) {
 				CHECK_SPACE(2);
 
-				// Do the one-shot connect.
+				// Hand the suspended function over to the await scheduler.
 				GET_VARIANT_PTR(argobj, 0);
 
 				Signal sig;
@@ -2567,15 +3600,9 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 					Ref<RuztaFunctionState> gdfs = memnew(RuztaFunctionState);
 					gdfs->function = this;
 
-					gdfs->state.stack.resize(alloca_size);
-
-					// First `FIXED_ADDRESSES_MAX` stack addresses are special, so we just skip them here.
-					for (int i = FIXED_ADDRESSES_MAX; i < _stack_size; i++) {
-						memnew_placement(&gdfs->state.stack.write[sizeof(Variant) * i], Variant(stack[i]));
-					}
 					gdfs->state.stack_size = _stack_size;
 					gdfs->state.ip = ip + 2;
-					gdfs->state.line = line;
+					gdfs->state.line = get_line(ip);
 					gdfs->state.script = _script;
 					{
 						MutexLock lock(RuztaLanguage::get_singleton()->mutex);
@@ -2603,12 +3630,30 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 
 					retvalue = gdfs;
 
-					Error err = sig.connect(Callable(gdfs.ptr(), "_signal_callback").bind(retvalue), Object::CONNECT_ONE_SHOT);
+					Error err = RuztaLanguage::get_singleton()->get_await_scheduler()->await_signal(sig, gdfs);
 					if (err != OK) {
 						err_text = "Error connecting to signal: " + sig.get_name() + " during await.";
 						OPCODE_BREAK;
 					}
 
+					if (p_state) {
+						// A resumed frame already lives in its state, move it along.
+						gdfs->state.stack = p_state->stack;
+						p_state->stack = Vector<uint8_t>();
+						p_state->stack_size = 0;
+						frame_handed_over = true;
+					} else if (!heap_frame.is_empty()) {
+						gdfs->state.stack = heap_frame;
+						frame_handed_over = true;
+					} else {
+						gdfs->state.stack.resize(alloca_size);
+
+						// First `FIXED_ADDRESSES_MAX` stack addresses are special, so we just skip them here.
+						for (int i = FIXED_ADDRESSES_MAX; i < _stack_size; i++) {
+							memnew_placement(&gdfs->state.stack.write[sizeof(Variant) * i], Variant(stack[i]));
+						}
+					}
+
 					awaited = true;
 
 #ifdef DEBUG_ENABLED
@@ -2633,16 +3678,76 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_YIELD) {
+				CHECK_SPACE(2);
+
+				GET_VARIANT_PTR(value, 0);
+
+				if (p_state) {
+					GD_ERR_BREAK(!p_state->generator);
+
+					// The generator keeps its state, just remember where to continue.
+					p_state->ip = ip + 2;
+					p_state->line = get_line(ip);
+					p_state->yielded = true;
+					{
+						MutexLock lock(RuztaLanguage::get_singleton()->mutex);
+						_script->pending_func_states.add(&p_state->generator->scripts_list);
+						if (p_instance) {
+							p_instance->pending_func_states.add(&p_state->generator->instances_list);
+						}
+					}
+					retvalue = *value;
+				} else {
+					// Calling a generator stops here, before the body, and returns the
+					// state that runs the rest of it when iterated.
+					Ref<RuztaFunctionState> gdfs = memnew(RuztaFunctionState);
+					gdfs->function = this;
+
+					gdfs->state.generator = gdfs.ptr();
+					gdfs->state.stack_size = _stack_size;
+					gdfs->state.ip = ip + 2;
+					gdfs->state.line = get_line(ip);
+					gdfs->state.script = _script;
+					{
+						MutexLock lock(RuztaLanguage::get_singleton()->mutex);
+						_script->pending_func_states.add(&gdfs->scripts_list);
+						if (p_instance) {
+							gdfs->state.instance = p_instance;
+							p_instance->pending_func_states.add(&gdfs->instances_list);
+						} else {
+							gdfs->state.instance = nullptr;
+						}
+					}
+#ifdef DEBUG_ENABLED
+					gdfs->state.function_name = name;
+					gdfs->state.script_path = _script->get_script_path();
+#endif
+					gdfs->state.defarg = defarg;
+					gdfs->state.stack = heap_frame;
+
+					retvalue = gdfs;
+				}
+
+				frame_handed_over = true;
+				awaited = true;
+
+#ifdef DEBUG_ENABLED
+				exit_ok = true;
+#endif
+				OPCODE_BREAK;
+			}
+
 			OPCODE(OPCODE_CREATE_LAMBDA) {
 				LOAD_INSTRUCTION_ARGS
 				CHECK_SPACE(2 + instr_arg_count);
 
 				ip += instr_arg_count;
 
-				int captures_count = _code_ptr[ip + 1];
+				int captures_count = CODE(ip + 1);
 				GD_ERR_BREAK(captures_count < 0);
 
-				int lambda_index = _code_ptr[ip + 2];
+				int lambda_index = CODE(ip + 2);
 				GD_ERR_BREAK(lambda_index < 0 || lambda_index >= _lambdas_count);
 				RuztaFunction *lambda = _lambdas_ptr[lambda_index];
 
@@ -2670,10 +3775,10 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 
 				ip += instr_arg_count;
 
-				int captures_count = _code_ptr[ip + 1];
+				int captures_count = CODE(ip + 1);
 				GD_ERR_BREAK(captures_count < 0);
 
-				int lambda_index = _code_ptr[ip + 2];
+				int lambda_index = CODE(ip + 2);
 				GD_ERR_BREAK(lambda_index < 0 || lambda_index >= _lambdas_count);
 				RuztaFunction *lambda = _lambdas_ptr[lambda_index];
 
@@ -2700,7 +3805,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 
 			OPCODE(OPCODE_JUMP) {
 				CHECK_SPACE(2);
-				int to = _code_ptr[ip + 1];
+				int to = CODE(ip + 1);
 
 				GD_ERR_BREAK(to < 0 || to > _code_size);
 				ip = to;
@@ -2715,7 +3820,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				bool result = test->booleanize();
 
 				if (result) {
-					int to = _code_ptr[ip + 2];
+					int to = CODE(ip + 2);
 					GD_ERR_BREAK(to < 0 || to > _code_size);
 					ip = to;
 				} else {
@@ -2732,7 +3837,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				bool result = test->booleanize();
 
 				if (!result) {
-					int to = _code_ptr[ip + 2];
+					int to = CODE(ip + 2);
 					GD_ERR_BREAK(to < 0 || to > _code_size);
 					ip = to;
 				} else {
@@ -2753,7 +3858,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				GET_VARIANT_PTR(val, 0);
 
 				if (val->is_shared()) {
-					int to = _code_ptr[ip + 2];
+					int to = CODE(ip + 2);
 					GD_ERR_BREAK(to < 0 || to > _code_size);
 					ip = to;
 				} else {
@@ -2765,7 +3870,11 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 			OPCODE(OPCODE_RETURN) {
 				CHECK_SPACE(2);
 				GET_VARIANT_PTR(r, 0);
-				retvalue = *r;
+				if (_can_move_return(CODE(ip + 1), borrowed_args)) {
+					retvalue = std::move(*r);
+				} else {
+					retvalue = *r;
+				}
 #ifdef DEBUG_ENABLED
 				exit_ok = true;
 #endif
@@ -2776,7 +3885,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				CHECK_SPACE(3);
 				GET_VARIANT_PTR(r, 0);
 
-				Variant::Type ret_type = (Variant::Type)_code_ptr[ip + 2];
+				Variant::Type ret_type = (Variant::Type)CODE(ip + 2);
 				GD_ERR_BREAK(ret_type < 0 || ret_type >= Variant::VARIANT_MAX);
 
 				if (r->get_type() != ret_type) {
@@ -2794,6 +3903,8 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 						RuztaVariantExtension::construct(ret_type, retvalue, nullptr, 0, ce);
 						OPCODE_BREAK;
 					}
+				} else if (_can_move_return(CODE(ip + 1), borrowed_args)) {
+					retvalue = std::move(*r);
 				} else {
 					retvalue = *r;
 				}
@@ -2808,8 +3919,8 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				GET_VARIANT_PTR(r, 0);
 
 				GET_VARIANT_PTR(script_type, 1);
-				Variant::Type builtin_type = (Variant::Type)_code_ptr[ip + 3];
-				int native_type_idx = _code_ptr[ip + 4];
+				Variant::Type builtin_type = (Variant::Type)CODE(ip + 3);
+				int native_type_idx = CODE(ip + 4);
 				GD_ERR_BREAK(native_type_idx < 0 || native_type_idx >= _global_names_count);
 				const StringName native_type = _global_names_ptr[native_type_idx];
 
@@ -2844,14 +3955,14 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				GET_VARIANT_PTR(r, 0);
 
 				GET_VARIANT_PTR(key_script_type, 1);
-				Variant::Type key_builtin_type = (Variant::Type)_code_ptr[ip + 4];
-				int key_native_type_idx = _code_ptr[ip + 5];
+				Variant::Type key_builtin_type = (Variant::Type)CODE(ip + 4);
+				int key_native_type_idx = CODE(ip + 5);
 				GD_ERR_BREAK(key_native_type_idx < 0 || key_native_type_idx >= _global_names_count);
 				const StringName key_native_type = _global_names_ptr[key_native_type_idx];
 
 				GET_VARIANT_PTR(value_script_type, 2);
-				Variant::Type value_builtin_type = (Variant::Type)_code_ptr[ip + 6];
-				int value_native_type_idx = _code_ptr[ip + 7];
+				Variant::Type value_builtin_type = (Variant::Type)CODE(ip + 6);
+				int value_native_type_idx = CODE(ip + 7);
 				GD_ERR_BREAK(value_native_type_idx < 0 || value_native_type_idx >= _global_names_count);
 				const StringName value_native_type = _global_names_ptr[value_native_type_idx];
 
@@ -2987,12 +4098,35 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				OPCODE_BREAK;
 			}
 
+			// Superinstructions run the ASSIGN of the container at their position, then fall through to the loop start right after it.
+			OPCODE(OPCODE_ASSIGN_ITERATE_BEGIN) {
+				CHECK_SPACE(3);
+				GET_VARIANT_PTR(dst, 0);
+				GET_VARIANT_PTR(src, 1);
+
+				*dst = *src;
+
+				ip += 3;
+			}
 			OPCODE(OPCODE_ITERATE_BEGIN) {
 				CHECK_SPACE(8); // Space for this and a regular iterate.
 
 				GET_VARIANT_PTR(counter, 0);
 				GET_VARIANT_PTR(container, 1);
 
+				RuztaFunctionState *generator = _get_generator(container);
+				if (generator) {
+					GET_VARIANT_PTR(iterator, 2);
+					if (generator->resume_generator(*iterator)) {
+						ip += 5; // Skip regular iterate which is always next.
+					} else {
+						int jumpto = CODE(ip + 4);
+						GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
+						ip = jumpto;
+					}
+					DISPATCH_OPCODE;
+				}
+
 				*counter = Variant();
 
 				bool valid;
@@ -3003,7 +4137,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 						OPCODE_BREAK;
 					}
 #endif
-					int jumpto = _code_ptr[ip + 4];
+					int jumpto = CODE(ip + 4);
 					GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
 					ip = jumpto;
 				} else {
@@ -3041,7 +4175,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 					ip += 5;
 				} else {
 					// Jump to end of loop.
-					int jumpto = _code_ptr[ip + 4];
+					int jumpto = CODE(ip + 4);
 					GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
 					ip = jumpto;
 				}
@@ -3068,7 +4202,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 					ip += 5;
 				} else {
 					// Jump to end of loop.
-					int jumpto = _code_ptr[ip + 4];
+					int jumpto = CODE(ip + 4);
 					GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
 					ip = jumpto;
 				}
@@ -3095,7 +4229,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 					ip += 5;
 				} else {
 					// Jump to end of loop.
-					int jumpto = _code_ptr[ip + 4];
+					int jumpto = CODE(ip + 4);
 					GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
 					ip = jumpto;
 				}
@@ -3122,7 +4256,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 					ip += 5;
 				} else {
 					// Jump to end of loop.
-					int jumpto = _code_ptr[ip + 4];
+					int jumpto = CODE(ip + 4);
 					GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
 					ip = jumpto;
 				}
@@ -3154,7 +4288,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 					ip += 5;
 				} else {
 					// Jump to end of loop.
-					int jumpto = _code_ptr[ip + 4];
+					int jumpto = CODE(ip + 4);
 					GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
 					ip = jumpto;
 				}
@@ -3186,7 +4320,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 					ip += 5;
 				} else {
 					// Jump to end of loop.
-					int jumpto = _code_ptr[ip + 4];
+					int jumpto = CODE(ip + 4);
 					GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
 					ip = jumpto;
 				}
@@ -3213,7 +4347,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 					ip += 5;
 				} else {
 					// Jump to end of loop.
-					int jumpto = _code_ptr[ip + 4];
+					int jumpto = CODE(ip + 4);
 					GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
 					ip = jumpto;
 				}
@@ -3238,13 +4372,22 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 					ip += 5;
 				} else {
 					// Jump to end of loop.
-					int jumpto = _code_ptr[ip + 4];
+					int jumpto = CODE(ip + 4);
 					GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
 					ip = jumpto;
 				}
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_ASSIGN_ITERATE_BEGIN_ARRAY) {
+				CHECK_SPACE(3);
+				GET_VARIANT_PTR(dst, 0);
+				GET_VARIANT_PTR(src, 1);
+
+				*dst = *src;
+
+				ip += 3;
+			}
 			OPCODE(OPCODE_ITERATE_BEGIN_ARRAY) {
 				CHECK_SPACE(8); // Check space for iterate instruction too.
 
@@ -3264,7 +4407,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 					ip += 5;
 				} else {
 					// Jump to end of loop.
-					int jumpto = _code_ptr[ip + 4];
+					int jumpto = CODE(ip + 4);
 					GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
 					ip = jumpto;
 				}
@@ -3286,7 +4429,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 			*it = array->get(0);                                                                                           \
 			ip += 5;                                                                                                       \
 		} else {                                                                                                           \
-			int jumpto = _code_ptr[ip + 4];                                                                                \
+			int jumpto = CODE(ip + 4);                                                                                     \
 			GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);                                                               \
 			ip = jumpto;                                                                                                   \
 		}                                                                                                                  \
@@ -3323,6 +4466,19 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				Object *obj = *VariantInternal::get_object(container);
 #endif
 
+				RuztaFunctionState *generator = _get_generator(container);
+				if (generator) {
+					GET_VARIANT_PTR(iterator, 2);
+					if (generator->resume_generator(*iterator)) {
+						ip += 5; // Loop again.
+					} else {
+						int jumpto = CODE(ip + 4);
+						GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
+						ip = jumpto;
+					}
+					DISPATCH_OPCODE;
+				}
+
 				*counter = Variant();
 				Array ref = { *counter };
 				Variant vref;
@@ -3341,7 +4497,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				}
 #endif
 				if (!has_next.booleanize()) {
-					int jumpto = _code_ptr[ip + 4];
+					int jumpto = CODE(ip + 4);
 					GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
 					ip = jumpto;
 				} else {
@@ -3387,7 +4543,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 					ip += 7;
 				} else {
 					// Jump to end of loop.
-					int jumpto = _code_ptr[ip + 6];
+					int jumpto = CODE(ip + 6);
 					GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
 					ip = jumpto;
 				}
@@ -3400,6 +4556,19 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				GET_VARIANT_PTR(counter, 0);
 				GET_VARIANT_PTR(container, 1);
 
+				RuztaFunctionState *generator = _get_generator(container);
+				if (generator) {
+					GET_VARIANT_PTR(iterator, 2);
+					if (generator->resume_generator(*iterator)) {
+						ip += 5; // Loop again.
+					} else {
+						int jumpto = CODE(ip + 4);
+						GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
+						ip = jumpto;
+					}
+					DISPATCH_OPCODE;
+				}
+
 				bool valid;
 				if (!container->iter_next(*counter, valid)) {
 #ifdef DEBUG_ENABLED
@@ -3408,7 +4577,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 						OPCODE_BREAK;
 					}
 #endif
-					int jumpto = _code_ptr[ip + 4];
+					int jumpto = CODE(ip + 4);
 					GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
 					ip = jumpto;
 				} else {
@@ -3438,7 +4607,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				(*count)++;
 
 				if (*count >= size) {
-					int jumpto = _code_ptr[ip + 4];
+					int jumpto = CODE(ip + 4);
 					GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
 					ip = jumpto;
 				} else {
@@ -3462,7 +4631,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				(*count)++;
 
 				if (*count >= size) {
-					int jumpto = _code_ptr[ip + 4];
+					int jumpto = CODE(ip + 4);
 					GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
 					ip = jumpto;
 				} else {
@@ -3486,7 +4655,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				(*count)++;
 
 				if (*count >= bounds->y) {
-					int jumpto = _code_ptr[ip + 4];
+					int jumpto = CODE(ip + 4);
 					GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
 					ip = jumpto;
 				} else {
@@ -3510,7 +4679,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				(*count)++;
 
 				if (*count >= bounds->y) {
-					int jumpto = _code_ptr[ip + 4];
+					int jumpto = CODE(ip + 4);
 					GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
 					ip = jumpto;
 				} else {
@@ -3534,7 +4703,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				*count += bounds->z;
 
 				if ((bounds->z < 0 && *count <= bounds->y) || (bounds->z > 0 && *count >= bounds->y)) {
-					int jumpto = _code_ptr[ip + 4];
+					int jumpto = CODE(ip + 4);
 					GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
 					ip = jumpto;
 				} else {
@@ -3558,7 +4727,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				*count += bounds->z;
 
 				if ((bounds->z < 0 && *count <= bounds->y) || (bounds->z > 0 && *count >= bounds->y)) {
-					int jumpto = _code_ptr[ip + 4];
+					int jumpto = CODE(ip + 4);
 					GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
 					ip = jumpto;
 				} else {
@@ -3581,7 +4750,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				(*idx)++;
 
 				if (*idx >= str->length()) {
-					int jumpto = _code_ptr[ip + 4];
+					int jumpto = CODE(ip + 4);
 					GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
 					ip = jumpto;
 				} else {
@@ -3603,7 +4772,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				const Variant *next = dict->next(counter);
 
 				if (!next) {
-					int jumpto = _code_ptr[ip + 4];
+					int jumpto = CODE(ip + 4);
 					GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
 					ip = jumpto;
 				} else {
@@ -3627,7 +4796,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				(*idx)++;
 
 				if (*idx >= array->size()) {
-					int jumpto = _code_ptr[ip + 4];
+					int jumpto = CODE(ip + 4);
 					GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
 					ip = jumpto;
 				} else {
@@ -3648,7 +4817,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 		int64_t *idx = VariantInternal::get_int(counter);                                           \
 		(*idx)++;                                                                                   \
 		if (*idx >= array->size()) {                                                                \
-			int jumpto = _code_ptr[ip + 4];                                                         \
+			int jumpto = CODE(ip + 4);                                                              \
 			GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);                                        \
 			ip = jumpto;                                                                            \
 		} else {                                                                                    \
@@ -3689,6 +4858,19 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				Object *obj = *VariantInternal::get_object(container);
 #endif
 
+				RuztaFunctionState *generator = _get_generator(container);
+				if (generator) {
+					GET_VARIANT_PTR(iterator, 2);
+					if (generator->resume_generator(*iterator)) {
+						ip += 5; // Loop again.
+					} else {
+						int jumpto = CODE(ip + 4);
+						GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
+						ip = jumpto;
+					}
+					DISPATCH_OPCODE;
+				}
+
 				Array ref = { *counter };
 				Variant vref;
 				VariantInternal::initialize(&vref, Variant::ARRAY);
@@ -3706,7 +4888,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				}
 #endif
 				if (!has_next.booleanize()) {
-					int jumpto = _code_ptr[ip + 4];
+					int jumpto = CODE(ip + 4);
 					GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
 					ip = jumpto;
 				} else {
@@ -3741,7 +4923,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 				*count += step;
 
 				if ((step < 0 && *count <= to) || (step > 0 && *count >= to)) {
-					int jumpto = _code_ptr[ip + 5];
+					int jumpto = CODE(ip + 5);
 					GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
 					ip = jumpto;
 				} else {
@@ -3755,7 +4937,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 
 			OPCODE(OPCODE_STORE_GLOBAL) {
 				CHECK_SPACE(3);
-				int global_idx = _code_ptr[ip + 2];
+				int global_idx = CODE(ip + 2);
 				GD_ERR_BREAK(global_idx < 0 || global_idx >= RuztaLanguage::get_singleton()->get_global_array_size());
 
 				GET_VARIANT_PTR(dst, 0);
@@ -3767,7 +4949,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 
 			OPCODE(OPCODE_STORE_NAMED_GLOBAL) {
 				CHECK_SPACE(3);
-				int globalname_idx = _code_ptr[ip + 2];
+				int globalname_idx = CODE(ip + 2);
 				GD_ERR_BREAK(globalname_idx < 0 || globalname_idx >= _global_names_count);
 				const StringName *globalname = &_global_names_ptr[globalname_idx];
 				GD_ERR_BREAK(!RuztaLanguage::get_singleton()->get_named_globals_map().has(*globalname));
@@ -3836,7 +5018,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 
 				if (!result) {
 					String message_str;
-					if (_code_ptr[ip + 2] != 0) {
+					if (CODE(ip + 2) != 0) {
 						GET_VARIANT_PTR(message, 1);
 						Variant message_var = *message;
 						if (message->get_type() != Variant::NIL) {
@@ -3869,7 +5051,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 			OPCODE(OPCODE_LINE) {
 				CHECK_SPACE(2);
 
-				line = _code_ptr[ip + 1];
+				line = CODE(ip + 1);
 				ip += 2;
 
 				if (EngineDebugger::get_singleton()->is_active()) {
@@ -3907,7 +5089,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 
 #if 0 // Enable for debugging.
 			default: {
-				err_text = "Illegal opcode " + itos(_code_ptr[ip]) + " at address " + itos(ip);
+				err_text = "Illegal opcode " + itos(CODE(ip)) + " at address " + itos(ip);
 				OPCODE_BREAK;
 			}
 #endif
@@ -3934,7 +5116,7 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 		if (instance_valid_with_script && p_instance->script->local_name != StringName()) {
 			err_func = String(p_instance->script->local_name) + "." + err_func;
 		}
-		int err_line = line;
+		int err_line = get_line(ip);
 		if (err_text.is_empty()) {
 			err_text = "Internal script error! Opcode: " + itos(last_opcode) + " (please report).";
 		}
@@ -3951,12 +5133,10 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 
 	OPCODES_OUT
 #ifdef DEBUG_ENABLED
-	if (RuztaLanguage::get_singleton()->profiling) {
+	if (profile_counts != nullptr) {
 		uint64_t time_taken = OS::get_singleton()->get_ticks_usec() - function_start_time;
-		profile.total_time.add(time_taken);
-		profile.self_time.add(time_taken - function_call_time);
-		profile.frame_total_time.add(time_taken);
-		profile.frame_self_time.add(time_taken - function_call_time);
+		Profile::ThreadCounts::add(profile_counts->total_time, time_taken);
+		Profile::ThreadCounts::add(profile_counts->self_time, time_taken - function_call_time);
 		if (OS::get_singleton()->get_thread_caller_id() == OS::get_singleton()->get_main_thread_id()) {
 			RuztaLanguage::get_singleton()->script_frame_time += time_taken - function_call_time;
 		}
@@ -3970,8 +5150,17 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 		RuztaLanguage::get_singleton()->exit_function();
 
 		// Free stack, except reserved addresses.
-		for (int i = FIXED_ADDRESSES_MAX; i < _stack_size; i++) {
-			stack[i].~Variant();
+		if (!frame_handed_over) {
+			// Borrowed slots still hold the caller's value, reset them without releasing it.
+			for (int i = 0; i < 64 && (borrowed_args >> i); i++) {
+				if (borrowed_args & (uint64_t(1) << i)) {
+					memnew_placement(&stack[i + FIXED_ADDRESSES_MAX], Variant);
+				}
+			}
+			// Slots that only ever hold trivial types don't need it.
+			for (int i = 0; i < _nontrivial_slots_count; i++) {
+				stack[_nontrivial_slots_ptr[i]].~Variant();
+			}
 		}
 	}
 
@@ -3985,9 +5174,11 @@ Variant RuztaFunction::call(RuztaInstance *p_instance, const Variant **p_args, i
 	if (p_state && !awaited) {
 		// This means we have finished executing a resumed function and it was not awaited again.
 
-		// Signal the next function-state to resume.
-		const Variant *args[1] = { &retvalue };
-		p_state->completed.emit(args, 1);
+		// Signal the next function-state to resume. Generators are not awaited, they just stop.
+		if (!_generator) {
+			const Variant *args[1] = { &retvalue };
+			p_state->completed.emit(args, 1);
+		}
 
 		// Exit function only after executing the remaining function states to preserve async call stack.
 		RuztaLanguage::get_singleton()->exit_function();
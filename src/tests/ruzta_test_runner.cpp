@@ -39,6 +39,7 @@
 #include "../ruzta_tokenizer_buffer.h"
 
 #include <godot_cpp/classes/project_settings.hpp> // original: core/config/project_settings.h
+#include <godot_cpp/classes/config_file.hpp> // original: core/io/config_file.h
 // TODO: #include "core/core_globals.h" // original: core/core_globals.h
 #include <godot_cpp/classes/dir_access.hpp> // original: core/io/dir_access.h
 // TODO: #include "core/io/file_access_pack.h" // original: core/io/file_access_pack.h
@@ -689,12 +690,56 @@ RuztaTest::TestResult RuztaTest::execute_test_code(bool p_is_generating) {
 	return result;
 }
 
+// A test can change project settings while it runs with a `[settings]` section in a `.cfg` file next to it,
+// and count calls like the script profiler does with `profiling=true` in its `[test]` section.
+RuztaTest::TestConfig RuztaTest::apply_test_config() const {
+	TestConfig config;
+	ConfigFile conf;
+	if (conf.load(source_file.get_basename() + ".cfg") != OK) {
+		return config;
+	}
+	if (conf.has_section("settings")) {
+		for (const String &setting : conf.get_section_keys("settings")) {
+			config.previous_settings[setting] = ProjectSettings::get_singleton()->get_setting(setting);
+			ProjectSettings::get_singleton()->set_setting(setting, conf.get_value("settings", setting));
+		}
+		RuztaLanguage::get_singleton()->update_optimization_settings();
+	}
+#ifdef DEBUG_ENABLED
+	config.profiling = conf.get_value("test", "profiling", false);
+	if (config.profiling) {
+		RuztaLanguage::get_singleton()->_profiling_start();
+	}
+#endif // DEBUG_ENABLED
+	return config;
+}
+
+void RuztaTest::restore_test_config(const TestConfig &p_config) const {
+#ifdef DEBUG_ENABLED
+	if (p_config.profiling) {
+		RuztaLanguage::get_singleton()->_profiling_stop();
+	}
+#endif // DEBUG_ENABLED
+	if (p_config.previous_settings.is_empty()) {
+		return;
+	}
+	for (const Variant &setting : p_config.previous_settings.keys()) {
+		ProjectSettings::get_singleton()->set_setting(setting, p_config.previous_settings[setting]);
+	}
+	RuztaLanguage::get_singleton()->update_optimization_settings();
+}
+
 RuztaTest::TestResult RuztaTest::run_test() {
-	return execute_test_code(false);
+	const TestConfig config = apply_test_config();
+	TestResult result = execute_test_code(false);
+	restore_test_config(config);
+	return result;
 }
 
 bool RuztaTest::generate_output() {
+	const TestConfig config = apply_test_config();
 	TestResult result = execute_test_code(true);
+	restore_test_config(config);
 	if (result.status == GDTEST_LOAD_ERROR) {
 		return false;
 	}
@@ -38,6 +38,7 @@
 // TODO: #include "core/string/print_string.h" // original: core/string/print_string.h
 #include <godot_cpp/variant/string.hpp> // original: core/string/ustring.h
 #include <godot_cpp/templates/vector.hpp> // original: core/templates/vector.h
+#include <godot_cpp/variant/dictionary.hpp> // original: core/variant/dictionary.h
 
 namespace RuztaTests {
 
@@ -93,6 +94,14 @@ private:
 	String get_text_for_status(TestStatus p_status) const;
 
 	TestResult execute_test_code(bool p_is_generating);
+	// Set up from an optional `.cfg` file next to the test, only while it runs.
+	struct TestConfig {
+		Dictionary previous_settings;
+		bool profiling = false;
+	};
+
+	TestConfig apply_test_config() const;
+	void restore_test_config(const TestConfig &p_config) const;
 
 public:
 	static void print_handler(void *p_this, const String &p_message, bool p_error, bool p_rich);
@@ -217,6 +217,7 @@ static void disassemble_function(const RuztaFunction *p_func, const Vector<Strin
 	print_line(vformat("Function %s(%s)", p_func->get_name(), arg_string));
 #ifdef TOOLS_ENABLED
 	p_func->disassemble(p_lines);
+	p_func->disassemble_optimizer_diff(p_lines);
 #endif
 	print_line("");
 	print_line("");